@@ -0,0 +1,84 @@
+#pragma once
+#include "B3L/ByteFrequencyTable.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace B3L::Benchmark {
+
+    // Small, fast and reproducible generator, the standard engines dominate the setup time of gigabyte haystacks.
+    class SplitMix64 {
+    public:
+        explicit SplitMix64(uint64_t seed) : state(seed) {
+        }
+
+        uint64_t operator()() noexcept {
+            auto z = (state += 0x9E3779B97F4A7C15);
+            z      = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+            z      = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+            return z ^ (z >> 31);
+        }
+
+    private:
+        uint64_t state;
+    };
+
+    // Uniformly distributed bytes.
+    inline std::vector<uint8_t> randomCorpus(size_t size, uint64_t seed) {
+        std::vector<uint8_t> data(size);
+        SplitMix64 rng(seed);
+
+        size_t i = 0;
+        for(; i + 8 <= size; i += 8) {
+            const auto r = rng();
+            for(size_t j = 0; j < 8; ++j)
+                data[i + j] = static_cast<uint8_t>(r >> (j * 8));
+        }
+        for(; i < size; ++i)
+            data[i] = static_cast<uint8_t>(rng());
+
+        return data;
+    }
+
+    // Bytes drawn independently from the byte distribution of x86-64 code. Matches the candidate rates of real code
+    // for anchor based scanning, but not its instruction level structure.
+    inline std::vector<uint8_t> codeCorpus(size_t size, uint64_t seed) {
+        // Inverse of the cumulative distribution, indexed by a 16 bit random number
+        std::array<uint8_t, 0x10000> inverse;
+        const auto& frequencies = ByteFrequencyTable::x86_64();
+
+        double cumulative = 0.0;
+        size_t next       = 0;
+        for(int b = 0; b < 256; ++b) {
+            cumulative += frequencies.matchProbability(static_cast<uint8_t>(b));
+            const auto end = b == 255 ? inverse.size() : (std::min)(inverse.size(), static_cast<size_t>(cumulative * 0x10000));
+            for(; next < end; ++next)
+                inverse[next] = static_cast<uint8_t>(b);
+        }
+
+        std::vector<uint8_t> data(size);
+        SplitMix64 rng(seed);
+
+        size_t i = 0;
+        for(; i + 4 <= size; i += 4) {
+            const auto r = rng();
+            for(size_t j = 0; j < 4; ++j)
+                data[i + j] = inverse[static_cast<uint16_t>(r >> (j * 16))];
+        }
+        for(; i < size; ++i)
+            data[i] = inverse[static_cast<uint16_t>(rng())];
+
+        return data;
+    }
+
+    // Repeats sample until size bytes are filled, e.g. to scale the code section of a real binary.
+    inline std::vector<uint8_t> tiledCorpus(const std::vector<uint8_t>& sample, size_t size) {
+        std::vector<uint8_t> data(size);
+        for(size_t i = 0; i < size && !sample.empty(); i += sample.size())
+            std::copy_n(sample.begin(), (std::min)(sample.size(), size - i), data.begin() + i);
+        return data;
+    }
+
+} // namespace B3L::Benchmark
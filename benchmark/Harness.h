@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace B3L::Benchmark {
+
+    using Value = std::variant<std::string, int64_t, double>;
+
+    struct Result {
+        std::string group;
+        std::string name;
+        std::vector<std::pair<std::string, Value>> parameters;
+        uint64_t bytes = 0; // Bytes processed per iteration
+        uint64_t items = 0; // Items processed per iteration
+        double seconds = 0; // Fastest iteration
+        int iterations = 0;
+
+        [[nodiscard]] double gigabytesPerSecond() const noexcept {
+            return seconds > 0 ? static_cast<double>(bytes) / seconds / 1e9 : 0.0;
+        }
+
+        [[nodiscard]] double itemsPerSecond() const noexcept {
+            return seconds > 0 ? static_cast<double>(items) / seconds : 0.0;
+        }
+    };
+
+    // Prevents the compiler from discarding a computed value.
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // Runs benchmark functions and collects their results. Each benchmark is repeated until it ran at least
+    // minIterations times and for minSeconds in total, the fastest iteration is reported.
+    class Runner {
+    public:
+        struct Options {
+            double minSeconds = 0.2;
+            int minIterations = 3;
+            std::string filter; // Only run benchmarks whose name contains filter
+        };
+
+        explicit Runner(Options options) : options(std::move(options)) {
+        }
+
+        // fn() performs one iteration and returns the number of bytes and items it processed.
+        template <typename Fn>
+        void run(std::string group, std::string name, std::vector<std::pair<std::string, Value>> parameters, Fn&& fn) {
+            const auto fullName = group + "/" + name;
+            if(!options.filter.empty() && fullName.find(options.filter) == std::string::npos)
+                return;
+
+            Result result{ std::move(group), std::move(name), std::move(parameters) };
+            result.seconds = 1e300;
+
+            double total = 0;
+            while(result.iterations < options.minIterations || total < options.minSeconds) {
+                const auto start          = std::chrono::steady_clock::now();
+                const auto [bytes, items] = fn();
+                const auto stop           = std::chrono::steady_clock::now();
+                const auto seconds        = std::chrono::duration<double>(stop - start).count();
+
+                result.bytes   = bytes;
+                result.items   = items;
+                result.seconds = (std::min)(result.seconds, seconds);
+                total += seconds;
+                ++result.iterations;
+            }
+
+            std::printf("%-72s %10.3f GB/s %14.0f items/s\n", fullName.c_str(), result.gigabytesPerSecond(),
+                        result.itemsPerSecond());
+            std::fflush(stdout);
+
+            results.push_back(std::move(result));
+        }
+
+        void writeJson(std::ostream& out, const std::vector<std::pair<std::string, Value>>& context) const {
+            out << "{\n  \"context\": {";
+            writeFields(out, context);
+            out << "},\n  \"benchmarks\": [\n";
+
+            for(size_t i = 0; i < results.size(); ++i) {
+                const auto& result = results[i];
+
+                std::vector<std::pair<std::string, Value>> fields = {
+                    { "group", result.group },
+                    { "name", result.name },
+                };
+                fields.insert(fields.end(), result.parameters.begin(), result.parameters.end());
+                fields.emplace_back("bytes", static_cast<int64_t>(result.bytes));
+                fields.emplace_back("items", static_cast<int64_t>(result.items));
+                fields.emplace_back("iterations", static_cast<int64_t>(result.iterations));
+                fields.emplace_back("seconds", result.seconds);
+                fields.emplace_back("gigabytesPerSecond", result.gigabytesPerSecond());
+                fields.emplace_back("itemsPerSecond", result.itemsPerSecond());
+
+                out << "    {";
+                writeFields(out, fields);
+                out << (i + 1 < results.size() ? "},\n" : "}\n");
+            }
+            out << "  ]\n}\n";
+        }
+
+    private:
+        static void writeString(std::ostream& out, const std::string& str) {
+            out << '"';
+            for(auto c : str) {
+                if(c == '"' || c == '\\')
+                    out << '\\' << c;
+                else if(static_cast<unsigned char>(c) < 0x20)
+                    out << ' ';
+                else
+                    out << c;
+            }
+            out << '"';
+        }
+
+        static void writeFields(std::ostream& out, const std::vector<std::pair<std::string, Value>>& fields) {
+            for(size_t i = 0; i < fields.size(); ++i) {
+                if(i)
+                    out << ", ";
+                writeString(out, fields[i].first);
+                out << ": ";
+
+                const auto& value = fields[i].second;
+                if(auto str = std::get_if<std::string>(&value)) {
+                    writeString(out, *str);
+                } else if(auto integer = std::get_if<int64_t>(&value)) {
+                    out << *integer;
+                } else {
+                    char buffer[32];
+                    std::snprintf(buffer, sizeof(buffer), "%.9g", std::get<double>(value));
+                    out << buffer;
+                }
+            }
+        }
+
+        Options options;
+        std::vector<Result> results;
+    };
+
+} // namespace B3L::Benchmark
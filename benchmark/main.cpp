@@ -0,0 +1,435 @@
+#include "B3L/AOBRegex.h"
+#include "B3L/AOBScanner.h"
+#include "B3L/CompiledPattern.h"
+#include "B3L/ImageIndex.h"
+#include "B3L/MappedFile.h"
+#include "B3L/SignatureDatabase.h"
+#include "Corpus.h"
+#include "Harness.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace B3L;
+using namespace B3L::Benchmark;
+
+namespace {
+
+    constexpr size_t MiB = 1024 * 1024;
+
+    struct Arguments {
+        size_t maxSize    = 256 * MiB;
+        double minSeconds = 0.2;
+        std::string filter;
+        std::string json;
+        std::string corpus;
+    };
+
+    struct Corpus {
+        std::string name;
+        std::vector<uint8_t> data;
+        ByteFrequencyTable frequencies;
+    };
+
+    enum class Position {
+        Early,  // Planted after 1% of the haystack
+        Late,   // Planted after 99% of the haystack
+        Absent, // Not planted
+    };
+
+    const char* positionName(Position position) {
+        switch(position) {
+            case Position::Early:
+                return "early";
+            case Position::Late:
+                return "late";
+            default:
+                return "absent";
+        }
+    }
+
+    std::string sizeName(size_t size) {
+        return std::to_string(size / MiB) + "MiB";
+    }
+
+    void printUsage() {
+        std::cerr << "Usage: b3l_benchmarks [options]\n"
+                     "  --max-size <MiB>   Largest haystack, default 256\n"
+                     "  --min-time <s>     Minimum total time per benchmark, default 0.2\n"
+                     "  --filter <text>    Only run benchmarks whose name contains text\n"
+                     "  --corpus <path>    Additional corpus tiled from the contents of a file, e.g. a .text section\n"
+                     "  --json <path>      Write results as JSON\n";
+    }
+
+    std::optional<Arguments> parseArguments(int argc, char** argv) {
+        Arguments args;
+        for(int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if(i + 1 >= argc) {
+                printUsage();
+                return std::nullopt;
+            }
+
+            const char* value = argv[++i];
+            if(arg == "--max-size")
+                args.maxSize = std::strtoull(value, nullptr, 10) * MiB;
+            else if(arg == "--min-time")
+                args.minSeconds = std::strtod(value, nullptr);
+            else if(arg == "--filter")
+                args.filter = value;
+            else if(arg == "--corpus")
+                args.corpus = value;
+            else if(arg == "--json")
+                args.json = value;
+            else {
+                printUsage();
+                return std::nullopt;
+            }
+        }
+
+        if(args.maxSize == 0) {
+            printUsage();
+            return std::nullopt;
+        }
+        return args;
+    }
+
+    // Pattern of length bytes sampled from the corpus. A fraction wildcards of the inner bytes are wildcards, the
+    // first and last byte are always exact.
+    AOBPattern makePattern(const Corpus& corpus, size_t length, double wildcards, uint64_t seed) {
+        SplitMix64 rng(seed);
+
+        std::vector<uint8_t> value(length);
+        std::vector<uint8_t> mask(length, 0xFF);
+        for(auto& b : value)
+            b = corpus.data[rng() % corpus.data.size()];
+
+        if(length > 2) {
+            auto remaining = static_cast<size_t>(wildcards * static_cast<double>(length - 2) + 0.5);
+            while(remaining) {
+                const auto i = 1 + rng() % (length - 2);
+                if(mask[i]) {
+                    mask[i]  = 0;
+                    value[i] = 0;
+                    --remaining;
+                }
+            }
+        }
+        return AOBPattern::fromBytes(value, mask).value();
+    }
+
+    // Writes the exact bytes of pattern to data, wildcards keep the corpus bytes.
+    void plant(uint8_t* data, const AOBPattern& pattern) {
+        for(size_t i = 0; i < pattern.size(); ++i)
+            data[i] = static_cast<uint8_t>((data[i] & ~pattern.mask()[i]) | pattern.value()[i]);
+    }
+
+    // AOBScanner::find with match positions early, late and absent. Throughput is computed from the bytes up to and
+    // including the first match, which may precede the planted one for short or sparse patterns.
+    void benchmarkFind(Runner& runner, Corpus& corpus, const std::vector<size_t>& sizes) {
+        for(auto size : sizes) {
+            for(size_t length : { 4, 8, 16, 32, 64 }) {
+                for(double wildcards : { 0.0, 0.25, 0.5 }) {
+                    for(auto position : { Position::Early, Position::Late, Position::Absent }) {
+                        const auto pattern = makePattern(corpus, length, wildcards, size ^ length << 8);
+
+                        const auto begin = corpus.data.data();
+                        const auto end   = begin + size;
+
+                        size_t offset = 0;
+                        std::vector<uint8_t> saved;
+                        if(position != Position::Absent) {
+                            offset = position == Position::Early ? size / 100 : size / 100 * 99;
+                            saved.assign(begin + offset, begin + offset + length);
+                            plant(begin + offset, pattern);
+                        }
+
+                        const auto match   = AOBScanner::find(begin, end, pattern);
+                        const auto scanned = match == end ? size : static_cast<size_t>(match - begin) + length;
+
+                        const auto name = corpus.name + "/" + sizeName(size) + "/len" + std::to_string(length) + "/wild" +
+                                          std::to_string(static_cast<int>(wildcards * 100)) + "/" + positionName(position);
+                        runner.run("find",
+                                   name,
+                                   {
+                                       { "corpus", corpus.name },
+                                       { "size", static_cast<int64_t>(size) },
+                                       { "length", static_cast<int64_t>(length) },
+                                       { "wildcards", wildcards },
+                                       { "position", std::string(positionName(position)) },
+                                       { "matchOffset", match == end ? int64_t(-1) : static_cast<int64_t>(match - begin) },
+                                   },
+                                   [&] {
+                                       doNotOptimize(AOBScanner::find(begin, end, pattern));
+                                       return std::pair<uint64_t, uint64_t>(scanned, 1);
+                                   });
+
+                        if(!saved.empty())
+                            std::copy(saved.begin(), saved.end(), begin + offset);
+                    }
+                }
+            }
+        }
+    }
+
+    // Compares the scan strategies on a single haystack. Full scans when the pattern is absent.
+    void benchmarkStrategies(Runner& runner, const Corpus& corpus, size_t size) {
+        const auto haystack = std::span<const uint8_t>(corpus.data.data(), size);
+        const auto begin    = haystack.data();
+        const auto end      = begin + size;
+
+        for(size_t length : { 8, 16, 32, 64, 128, 255 }) {
+            for(double wildcards : { 0.0, 0.25 }) {
+                const auto pattern  = makePattern(corpus, length, wildcards, ~(size ^ length << 8));
+                const auto compiled = CompiledPattern::compile(pattern, corpus.frequencies);
+
+                const auto match   = AOBScanner::find(begin, end, pattern);
+                const auto scanned = match == end ? size : static_cast<size_t>(match - begin) + length;
+
+                const auto prefix = corpus.name + "/" + sizeName(size) + "/len" + std::to_string(length) + "/wild" +
+                                    std::to_string(static_cast<int>(wildcards * 100)) + "/";
+
+                auto run = [&](const char* strategy, auto&& fn) {
+                    runner.run("strategy",
+                               prefix + strategy,
+                               {
+                                   { "corpus", corpus.name },
+                                   { "size", static_cast<int64_t>(size) },
+                                   { "length", static_cast<int64_t>(length) },
+                                   { "wildcards", wildcards },
+                                   { "strategy", std::string(strategy) },
+                                   { "matchOffset", match == end ? int64_t(-1) : static_cast<int64_t>(match - begin) },
+                               },
+                               [&] {
+                                   doNotOptimize(fn());
+                                   return std::pair<uint64_t, uint64_t>(scanned, 1);
+                               });
+                };
+
+                run("anchor", [&] { return AOBScanner::find(begin, end, pattern, ScanStrategy::Anchor); });
+                run("horspool", [&] { return AOBScanner::find(begin, end, pattern, ScanStrategy::Horspool); });
+                run("compiled", [&] { return compiled.find(begin, end); });
+                run("parallel", [&] { return AOBScanner::findParallel(haystack, pattern); });
+            }
+        }
+    }
+
+    // Fuzzy scans of absent patterns for increasing mismatch limits, full scans in every case.
+    void benchmarkApproximate(Runner& runner, const Corpus& corpus, size_t size) {
+        const auto haystack = std::span<const uint8_t>(corpus.data.data(), size);
+
+        for(size_t length : { 16, 32 }) {
+            const auto pattern = makePattern(corpus, length, 0.25, ~length);
+
+            for(size_t k : { 0, 1, 2, 4 }) {
+                runner.run("approximate",
+                           corpus.name + "/" + sizeName(size) + "/len" + std::to_string(length) + "/k" + std::to_string(k),
+                           {
+                               { "corpus", corpus.name },
+                               { "size", static_cast<int64_t>(size) },
+                               { "length", static_cast<int64_t>(length) },
+                               { "maxMismatches", static_cast<int64_t>(k) },
+                           },
+                           [&] {
+                               const auto matches = AOBScanner::findApproximate(haystack, pattern, k);
+                               doNotOptimize(matches.data());
+                               return std::pair<uint64_t, uint64_t>(size, matches.size());
+                           });
+            }
+        }
+    }
+
+    // AOBRegex on a single haystack, with the DFA and with the bit-parallel simulation.
+    void benchmarkRegex(Runner& runner, const Corpus& corpus, size_t size) {
+        const auto haystack = std::span<const uint8_t>(corpus.data.data(), size);
+
+        for(const auto& str : { "(E8|E9) ?? ?? ?? ?? [40-4F] 8B 0D 13", "48 8B 05 {4} 48 85 C0 {2,6} FF 15 37 13", "[00-03] {1,12} 7F 7E" }) {
+            for(size_t maxDfaStates : { AOBRegex::defaultMaxDfaStates, size_t{ 0 } }) {
+                const auto regex = AOBRegex::fromString(str, maxDfaStates).value();
+                const auto match = regex.find(haystack);
+
+                const auto scanned = match ? static_cast<size_t>(match->end - haystack.data()) : size;
+                const auto engine  = regex.usesDfa() ? "dfa" : "simulation";
+
+                runner.run("regex",
+                           corpus.name + "/" + sizeName(size) + "/" + str + (maxDfaStates ? "/default" : "/simulation"),
+                           {
+                               { "corpus", corpus.name },
+                               { "size", static_cast<int64_t>(size) },
+                               { "pattern", std::string(str) },
+                               { "engine", std::string(engine) },
+                           },
+                           [&] {
+                               doNotOptimize(regex.find(haystack));
+                               return std::pair<uint64_t, uint64_t>(scanned, 1);
+                           });
+            }
+        }
+    }
+
+    // Repeated queries against an ImageIndex compared to scanning, along with the cost of building the index.
+    void benchmarkIndex(Runner& runner, const Corpus& corpus, size_t size) {
+        const auto haystack = std::span<const uint8_t>(corpus.data.data(), size);
+        const auto prefix   = corpus.name + "/" + sizeName(size);
+
+        runner.run("index", prefix + "/build", { { "corpus", corpus.name }, { "size", static_cast<int64_t>(size) } }, [&] {
+            const ImageIndex index({ { 0, haystack } }, 1);
+            doNotOptimize(index.sections().data());
+            return std::pair<uint64_t, uint64_t>(size, 1);
+        });
+
+        const ImageIndex index({ { 0, haystack } }, 1);
+        for(double wildcards : { 0.0, 0.25 }) {
+            const auto pattern = makePattern(corpus, 16, wildcards, size ^ 0x1DE);
+            const auto name    = prefix + "/len16/wild" + std::to_string(static_cast<int>(wildcards * 100));
+
+            const std::vector<std::pair<std::string, Value>> parameters{
+                { "corpus", corpus.name },
+                { "size", static_cast<int64_t>(size) },
+                { "wildcards", wildcards },
+            };
+
+            runner.run("index", name + "/query", parameters, [&] {
+                const auto matches = index.findAll(pattern);
+                doNotOptimize(matches.data());
+                return std::pair<uint64_t, uint64_t>(size, 1);
+            });
+            runner.run("index", name + "/scan", parameters, [&] {
+                const auto matches = AOBScanner::findAll(haystack.begin(), haystack.end(), pattern);
+                doNotOptimize(matches.data());
+                return std::pair<uint64_t, uint64_t>(size, 1);
+            });
+        }
+    }
+
+    // Pattern and byte array string parsing. Throughput is measured in input characters.
+    void benchmarkParse(Runner& runner) {
+        constexpr int count = 1000;
+
+        for(size_t length : { 8, 32, 128 }) {
+            SplitMix64 rng(length);
+
+            std::string bytes;
+            std::string pattern;
+            for(size_t i = 0; i < length; ++i) {
+                char hex[4];
+                std::snprintf(hex, sizeof(hex), "%02X ", static_cast<unsigned>(rng() & 0xFF));
+                bytes += hex;
+                pattern += i % 4 == 2 ? "?? " : hex;
+            }
+
+            runner.run("parse",
+                       "AOBPattern::fromString/len" + std::to_string(length),
+                       { { "length", static_cast<int64_t>(length) } },
+                       [&] {
+                           for(int i = 0; i < count; ++i)
+                               doNotOptimize(AOBPattern::fromString(pattern));
+                           return std::pair<uint64_t, uint64_t>(count * pattern.size(), count);
+                       });
+
+            runner.run("parse",
+                       "parseByteArrayString/len" + std::to_string(length),
+                       { { "length", static_cast<int64_t>(length) } },
+                       [&] {
+                           for(int i = 0; i < count; ++i)
+                               doNotOptimize(parseByteArrayString(bytes));
+                           return std::pair<uint64_t, uint64_t>(count * bytes.size(), count);
+                       });
+        }
+
+        // A signature database, loaded in bulk and pattern by pattern
+        SplitMix64 rng(count);
+        std::string database;
+        std::vector<std::pair<size_t, size_t>> patterns; // Offset and length in database
+        for(int i = 0; i < 10 * count; ++i) {
+            database += "Signature" + std::to_string(i) + " | ";
+            const auto offset = database.size();
+            for(size_t j = 0, length = 8 + rng() % 24; j < length; ++j) {
+                char hex[4];
+                std::snprintf(hex, sizeof(hex), "%02X ", static_cast<unsigned>(rng() & 0xFF));
+                database += j % 5 == 3 ? "?? " : hex;
+            }
+            patterns.emplace_back(offset, database.size() - offset);
+            database += "| .text\n";
+        }
+
+        runner.run("parse", "SignatureDatabase", { { "signatures", static_cast<int64_t>(patterns.size()) } }, [&] {
+            const SignatureDatabase db(database);
+            doNotOptimize(db.size());
+            return std::pair<uint64_t, uint64_t>(database.size(), db.size());
+        });
+
+        runner.run("parse", "SignatureDatabase/fromString", { { "signatures", static_cast<int64_t>(patterns.size()) } }, [&] {
+            for(const auto& [offset, length] : patterns)
+                doNotOptimize(AOBPattern::fromString(database.substr(offset, length)));
+            return std::pair<uint64_t, uint64_t>(database.size(), patterns.size());
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto args = parseArguments(argc, argv);
+    if(!args)
+        return EXIT_FAILURE;
+
+    std::vector<size_t> sizes;
+    for(size_t size : { 1 * MiB, 16 * MiB, 256 * MiB, 1024 * MiB }) {
+        if(size <= args->maxSize)
+            sizes.push_back(size);
+    }
+    if(sizes.empty())
+        sizes.push_back(args->maxSize);
+
+    // Corpora are generated once at the largest size, smaller haystacks are prefixes
+    const auto maxSize = sizes.back();
+
+    std::vector<Corpus> corpora;
+    corpora.push_back({ "random", randomCorpus(maxSize, 1), {} });
+    corpora.back().frequencies = ByteFrequencyTable::fromSample(corpora.back().data);
+    corpora.push_back({ "code", codeCorpus(maxSize, 2), ByteFrequencyTable::x86_64() });
+
+    if(!args->corpus.empty()) {
+        try {
+            const MappedFile file(args->corpus);
+            std::vector<uint8_t> sample(file.data(), file.data() + file.size());
+            if(sample.empty())
+                throw std::runtime_error("File is empty");
+
+            corpora.push_back({ "file", tiledCorpus(sample, maxSize), ByteFrequencyTable::fromSample(sample) });
+        } catch(const std::exception& e) {
+            std::cerr << "Failed to load corpus " << args->corpus << ": " << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    Runner runner({ args->minSeconds, 3, args->filter });
+    for(auto& corpus : corpora)
+        benchmarkFind(runner, corpus, sizes);
+    for(auto& corpus : corpora)
+        benchmarkStrategies(runner, corpus, (std::min)(maxSize, 16 * MiB));
+    for(auto& corpus : corpora)
+        benchmarkApproximate(runner, corpus, (std::min)(maxSize, 16 * MiB));
+    for(auto& corpus : corpora)
+        benchmarkRegex(runner, corpus, (std::min)(maxSize, 16 * MiB));
+    for(auto& corpus : corpora)
+        benchmarkIndex(runner, corpus, (std::min)(maxSize, 4 * MiB));
+    benchmarkParse(runner);
+
+    if(!args->json.empty()) {
+        std::ofstream out(args->json);
+        runner.writeJson(out,
+                         {
+                             { "hardwareThreads", static_cast<int64_t>(std::thread::hardware_concurrency()) },
+                             { "maxSize", static_cast<int64_t>(maxSize) },
+                             { "minSeconds", args->minSeconds },
+                         });
+        if(!out) {
+            std::cerr << "Failed to write " << args->json << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
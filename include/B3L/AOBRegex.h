@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace B3L {
+
+    // AOB pattern with alternation, byte classes and variable length gaps, e.g. "(E8|E9) ?? ?? ?? ?? [40-4F] {2,6} C3".
+    // In addition to the AOBPattern byte syntax ("8B", "??", "4?", "?B", "8B/F8") it supports
+    //   "(48 8B|4C 8B)"  Alternation of sub patterns, an empty branch makes the group optional
+    //   "[40-4F 50]"     Byte class of ranges and bytes, "[^00 CC]" for its complement
+    //   "{4}" "{2,6}"    Gap of exactly 4, or 2 to 6 arbitrary bytes
+    // The pattern is compiled to a Glushkov automaton with one state per byte position. It is converted to a DFA if
+    // that stays small, otherwise the automaton is simulated bit-parallel. Both scan the haystack in a single pass.
+    class AOBRegex {
+    public:
+        struct Match {
+            const uint8_t* begin;
+            const uint8_t* end;
+
+            [[nodiscard]] bool operator==(const Match&) const noexcept = default;
+        };
+
+        static constexpr size_t maxPositions       = 64;
+        static constexpr size_t defaultMaxDfaStates = 1024;
+        static constexpr size_t maxDfaStateLimit    = 0x10000; // States are stored as 16 bit ids
+
+        // Returns std::nullopt if the string is malformed, has more than maxPositions byte positions or matches the
+        // empty string. A maxDfaStates of 0 always selects the bit-parallel simulation, values above
+        // maxDfaStateLimit are clamped.
+        [[nodiscard]] static std::optional<AOBRegex> fromString(std::string_view str, size_t maxDfaStates = defaultMaxDfaStates);
+
+        // Returns the match that ends first. Of the matches ending there the one that begins first is returned.
+        [[nodiscard]] std::optional<Match> find(std::span<const uint8_t> haystack) const noexcept;
+
+        // Returns one match for every position at which a match ends, each with the first begin.
+        [[nodiscard]] std::vector<Match> findAll(std::span<const uint8_t> haystack) const;
+
+        [[nodiscard]] size_t positionCount() const noexcept {
+            return follow.size();
+        }
+
+        [[nodiscard]] bool usesDfa() const noexcept {
+            return !transitions.empty();
+        }
+
+    private:
+        AOBRegex() = default;
+
+        // Scan position that can be resumed after a match.
+        struct ScanState {
+            uint64_t active = 0; // Positions matched by the last byte, bit-parallel simulation
+            uint32_t state  = 0; // DFA state
+        };
+
+        [[nodiscard]] uint64_t followOf(uint64_t positions) const noexcept;
+        [[nodiscard]] bool buildDfa(size_t maxStates);
+
+        // Returns the end of the next match in [pos, end) or nullptr if there is none.
+        [[nodiscard]] const uint8_t* findEnd(const uint8_t* pos, const uint8_t* end, ScanState& scanState) const noexcept;
+        [[nodiscard]] const uint8_t* skipToStart(const uint8_t* pos, const uint8_t* end) const noexcept;
+
+        // Walks back from a match end to the first begin of a match ending there.
+        [[nodiscard]] const uint8_t* findBegin(const uint8_t* begin, const uint8_t* matchEnd) const noexcept;
+
+        std::array<uint64_t, 256> byteMasks{}; // Positions that accept each byte value
+        std::vector<uint64_t> follow;          // Positions that may follow each position
+        std::vector<uint64_t> precede;         // Positions that may precede each position
+        uint64_t first = 0;                    // Positions a match may begin with
+        uint64_t last  = 0;                    // Positions a match may end with
+
+        // Bit-parallel simulation, followTables[k][b] are the positions following any of the positions 8k + bits of b
+        std::vector<std::array<uint64_t, 256>> followTables;
+
+        // DFA, accepting states are numbered from firstAccepting. State 0 is the state without active positions.
+        std::vector<uint16_t> transitions;
+        uint32_t firstAccepting = 0;
+
+        // Bytes that leave the start state, scanned for with memchr or SIMD compares if there are at most four.
+        std::vector<uint8_t> startBytes;
+    };
+
+} // namespace B3L
@@ -1,33 +1,417 @@
 #pragma once
+#include "AOBRegex.h"
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include <version>
+#ifdef __cpp_lib_generator
+    #include <generator>
+#endif
 
 namespace B3L {
 
     [[nodiscard]] std::optional<std::vector<uint8_t>> parseByteArrayString(const std::string& byteString);
 
+    // Pattern of fixed size parsed at compile time, see operator""_aob. Same value and mask layout as AOBPattern.
+    template <size_t N>
+    struct StaticAOBPattern {
+        static_assert(N > 0, "Pattern must not be empty");
+
+        std::array<uint8_t, N> value{};
+        std::array<uint8_t, N> mask{};
+
+        [[nodiscard]] static constexpr size_t size() noexcept {
+            return N;
+        }
+
+        // Offset of the first fully masked byte, -1 if there is none.
+        [[nodiscard]] constexpr int anchor() const noexcept {
+            for(size_t i = 0; i < N; ++i) {
+                if(mask[i] == 0xFF)
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+
+        template <std::forward_iterator FwdIter>
+        [[nodiscard]] constexpr bool matchesAt(FwdIter data) const {
+            for(size_t i = 0; i < N; ++i, ++data) {
+                if((static_cast<uint8_t>(*data) & mask[i]) != value[i])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // How the field of an AOBPattern::Capture is turned into its result.
+    enum class CaptureKind : uint8_t {
+        Raw,      // Sign extended field value, e.g. a displacement or immediate
+        Relative, // Sign extended field value plus the address of the next instruction, e.g. call rel32 or [rip+disp32]
+        Absolute, // Zero extended field value, e.g. an absolute address
+    };
+
+    namespace detail {
+
+        template <size_t N>
+        struct FixedString {
+            consteval FixedString(const char (&str)[N]) {
+                std::copy_n(str, N, data);
+            }
+
+            [[nodiscard]] constexpr std::string_view view() const noexcept {
+                return { data, N - 1 };
+            }
+
+            char data[N]{};
+        };
+
+        constexpr bool isPatternWhitespace(char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        constexpr int hexDigitValue(char c) noexcept {
+            if(c >= '0' && c <= '9')
+                return c - '0';
+            if(c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if(c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        struct CaptureMarker {
+            std::string_view name;
+            CaptureKind kind;
+            uint8_t size;
+            uint8_t trailing;
+        };
+
+        // Parses the contents of a capture marker, "[name:]kind size[+trailing]", e.g. "target:rel4" or "abs8".
+        constexpr std::optional<CaptureMarker> parseCaptureMarker(std::string_view str) {
+            CaptureMarker marker{};
+
+            if(const auto colon = str.find(':'); colon != std::string_view::npos) {
+                marker.name = str.substr(0, colon);
+                str         = str.substr(colon + 1);
+
+                for(char c : marker.name) {
+                    if(!(c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')))
+                        return std::nullopt;
+                }
+            }
+
+            if(str.starts_with("raw"))
+                marker.kind = CaptureKind::Raw;
+            else if(str.starts_with("rel"))
+                marker.kind = CaptureKind::Relative;
+            else if(str.starts_with("abs"))
+                marker.kind = CaptureKind::Absolute;
+            else
+                return std::nullopt;
+            str = str.substr(3);
+
+            if(str.empty() || (str[0] != '1' && str[0] != '2' && str[0] != '4' && str[0] != '8'))
+                return std::nullopt;
+            marker.size = static_cast<uint8_t>(str[0] - '0');
+            str         = str.substr(1);
+
+            // Instruction bytes after the field, e.g. the imm8 of cmp [rip+disp32], imm8
+            if(!str.empty()) {
+                if(marker.kind != CaptureKind::Relative || str[0] != '+' || str.size() < 2 || str.size() > 3)
+                    return std::nullopt;
+
+                int trailing = 0;
+                for(char c : str.substr(1)) {
+                    if(c < '0' || c > '9')
+                        return std::nullopt;
+                    trailing = trailing * 10 + (c - '0');
+                }
+                if(trailing > 15)
+                    return std::nullopt;
+                marker.trailing = static_cast<uint8_t>(trailing);
+            }
+            return marker;
+        }
+
+        struct IgnoreCapture {
+            constexpr void operator()(const CaptureMarker&, size_t) const noexcept {
+            }
+        };
+
+        // Parses a pattern string into parallel value and mask arrays, which may be nullptr to only count the bytes.
+        // Returns the number of pattern bytes or std::nullopt if the string is malformed. Whitespace is ignored.
+        // Every pattern byte is one of
+        //   "8B"     Exact byte
+        //   "??"     Wildcard
+        //   "4?"     High nibble, low nibble wildcard
+        //   "?B"     Low nibble, high nibble wildcard
+        //   "8B/F8"  Explicit bit mask
+        // A capture marker "<name:rel4>" stands for a field of wildcard bytes, see AOBPattern::Capture. onCapture is
+        // called with the marker and the offset of its field.
+        template <typename OnCapture = IgnoreCapture>
+        constexpr std::optional<size_t>
+        parsePattern(std::string_view str, uint8_t* value = nullptr, uint8_t* mask = nullptr, OnCapture onCapture = {}) {
+            size_t count = 0;
+            size_t pos   = 0;
+
+            // Returns next non-whitespace character or 0 at the end of the string
+            auto next = [&]() -> char {
+                while(pos < str.size() && isPatternWhitespace(str[pos]))
+                    ++pos;
+                return pos < str.size() ? str[pos++] : '\0';
+            };
+
+            for(char high = next(); high; high = next()) {
+                if(high == '<') {
+                    const auto close = str.find('>', pos);
+                    if(close == std::string_view::npos)
+                        return std::nullopt;
+
+                    const auto marker = parseCaptureMarker(str.substr(pos, close - pos));
+                    if(!marker)
+                        return std::nullopt;
+
+                    onCapture(*marker, count);
+                    for(size_t i = 0; i < marker->size; ++i, ++count) {
+                        if(value)
+                            value[count] = 0;
+                        if(mask)
+                            mask[count] = 0;
+                    }
+                    pos = close + 1;
+                    continue;
+                }
+
+                const char low = next();
+
+                const int highValue = hexDigitValue(high);
+                const int lowValue  = hexDigitValue(low);
+                if((highValue < 0 && high != '?') || (lowValue < 0 && low != '?'))
+                    return std::nullopt;
+
+                uint8_t byteValue = static_cast<uint8_t>((highValue < 0 ? 0 : highValue << 4) | (lowValue < 0 ? 0 : lowValue));
+                uint8_t byteMask  = static_cast<uint8_t>((highValue < 0 ? 0 : 0xF0) | (lowValue < 0 ? 0 : 0x0F));
+
+                // Explicit masks are only allowed for exact bytes
+                const auto save = pos;
+                if(next() == '/') {
+                    if(byteMask != 0xFF)
+                        return std::nullopt;
+
+                    const int maskHigh = hexDigitValue(next());
+                    const int maskLow  = hexDigitValue(next());
+                    if(maskHigh < 0 || maskLow < 0)
+                        return std::nullopt;
+
+                    byteMask = static_cast<uint8_t>(maskHigh << 4 | maskLow);
+                    byteValue &= byteMask;
+                } else {
+                    pos = save;
+                }
+
+                if(value)
+                    value[count] = byteValue;
+                if(mask)
+                    mask[count] = byteMask;
+                ++count;
+            }
+
+            if(count == 0)
+                return std::nullopt;
+
+            return count;
+        }
+
+        template <size_t N>
+        consteval size_t staticPatternSize(const FixedString<N>& str) {
+            const auto size = parsePattern(str.view());
+            if(!size)
+                throw std::invalid_argument("Malformed AOB pattern"); // Not a constant expression, fails compilation
+            return *size;
+        }
+
+        template <auto Pattern, size_t... I>
+        constexpr bool matchesStaticPattern(const uint8_t* data, std::index_sequence<I...>) noexcept {
+            // Wildcard terms fold to true at compile time
+            return (((Pattern.mask[I] == 0) || ((data[I] & Pattern.mask[I]) == Pattern.value[I])) && ...);
+        }
+
+    } // namespace detail
+
     struct AOBPattern {
     public:
+        // Field of wildcard bytes whose value is extracted from a match, declared in pattern strings as
+        // "<[name:]kind size[+trailing]>" with kind raw, rel or abs and size 1, 2, 4 or 8. trailing is the number of
+        // instruction bytes after the field, which a relative field is relative to as well. E.g.
+        //   "E8 <target:rel4>"            call target
+        //   "48 8B 05 <global:rel4>"      mov rax, [rip+global]
+        //   "83 3D <flag:rel4+1> 00"      cmp dword ptr [rip+flag], 0
+        //   "48 8B 81 <offset:raw4>"      mov rax, [rcx+offset]
+        struct Capture {
+            std::string name; // May be empty
+            CaptureKind kind;
+            size_t offset;    // Offset of the field in the pattern
+            uint8_t size;     // 1, 2, 4 or 8 bytes
+            uint8_t trailing; // Instruction bytes after the field, only used by CaptureKind::Relative
+
+            // Resolves the field of the match at data, where matchAddress is the address of data in the scanned
+            // address space, e.g. the RVA of the match when scanning an image file.
+            [[nodiscard]] uint64_t resolve(const uint8_t* match, uint64_t matchAddress) const noexcept;
+        };
+
+        // Returns std::nullopt if the string is malformed or captures have invalid or duplicate names.
         [[nodiscard]] static std::optional<AOBPattern> fromString(const std::string& str);
 
-        [[nodiscard]] std::vector<int16_t>::const_iterator begin() const noexcept;
-        [[nodiscard]] std::vector<int16_t>::const_iterator end() const noexcept;
+        // Creates pattern from parallel value and mask arrays. Returns std::nullopt if the sizes differ or are 0.
+        [[nodiscard]] static std::optional<AOBPattern> fromBytes(std::span<const uint8_t> value, std::span<const uint8_t> mask);
+
+        // As above with captures in pattern order. Also returns std::nullopt if a capture field exceeds the pattern or
+        // captures have duplicate names.
+        [[nodiscard]] static std::optional<AOBPattern>
+        fromBytes(std::span<const uint8_t> value, std::span<const uint8_t> mask, std::vector<Capture> captures);
+
+        template <size_t N>
+        [[nodiscard]] static AOBPattern fromStatic(const StaticAOBPattern<N>& pattern) {
+            return fromBytes(pattern.value, pattern.mask).value();
+        }
+
+        // A byte b matches pattern byte i if (b & mask()[i]) == value()[i]. Value bits outside the mask are always 0.
+        [[nodiscard]] std::span<const uint8_t> value() const noexcept;
+        [[nodiscard]] std::span<const uint8_t> mask() const noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+
+        // Stable hash of value and mask, suitable for persistent storage.
+        [[nodiscard]] uint64_t hash() const noexcept;
+
+        // Returns whether the pattern matches the size() bytes at data.
+        [[nodiscard]] bool matchesAt(const uint8_t* data) const noexcept;
+
+        template <std::forward_iterator FwdIter>
+        [[nodiscard]] bool matchesAt(FwdIter data) const {
+            for(size_t i = 0; i < _value.size(); ++i, ++data) {
+                if((static_cast<uint8_t>(*data) & _mask[i]) != _value[i])
+                    return false;
+            }
+            return true;
+        }
+
+        // Offsets of the non-wildcard bytes used to locate match candidates, chosen by how rarely they match in x86-64
+        // code (see ByteFrequencyTable::x86_64). -1 if the pattern consists of wildcards only.
+        [[nodiscard]] int primaryAnchor() const noexcept;
+        [[nodiscard]] int secondaryAnchor() const noexcept;
+
+        // Captures in pattern order.
+        [[nodiscard]] std::span<const Capture> captures() const noexcept;
+
+        // Returns nullptr if there is no capture called name.
+        [[nodiscard]] const Capture* capture(std::string_view name) const noexcept;
+
+        // Final address of a match at data located at matchAddress: the first capture resolved, or matchAddress if
+        // the pattern has no captures.
+        [[nodiscard]] uint64_t resolve(const uint8_t* match, uint64_t matchAddress) const noexcept;
 
     private:
         AOBPattern() = default;
 
-        [[nodiscard]] static bool isValidPatternString(const std::string& str);
+        void selectAnchors() noexcept;
+        [[nodiscard]] bool uniqueCaptureNames() const noexcept;
+
+        std::vector<uint8_t> _value;
+        std::vector<uint8_t> _mask;
+        std::vector<Capture> _captures;
+        int _primaryAnchor   = -1;
+        int _secondaryAnchor = -1;
+    };
+
+    inline namespace literals {
+
+        // Compile time AOB pattern, e.g. "48 8B ?? 05"_aob. Malformed patterns are compile errors. Capture markers are
+        // accepted but only contribute their wildcard bytes.
+        template <detail::FixedString Str>
+        consteval auto operator""_aob() {
+            constexpr auto size = detail::staticPatternSize(Str);
+
+            StaticAOBPattern<size> pattern;
+            detail::parsePattern(Str.view(), pattern.value.data(), pattern.mask.data());
+            return pattern;
+        }
+
+    } // namespace literals
+
+    // Search algorithm used for contiguous haystacks.
+    enum class ScanStrategy {
+        Auto,
+        // Vectorized compare on the anchor bytes of the pattern, candidates are verified against the full pattern.
+        Anchor,
+        // Horspool style skipping driven by the longest exact suffix of the pattern, large ranges are split into
+        // independent lanes that skip in lockstep. Only beats Anchor for long exact suffixes (~64 bytes and up), short
+        // ones are slower. Falls back to Anchor if the last pattern byte isn't exact.
+        Horspool,
+    };
+
+    namespace detail {
 
-        std::vector<int16_t> _bytes;
+        // Returns pointer to the first match of needle in [begin, end) or end if there is none.
+        [[nodiscard]] const uint8_t* findPattern(const uint8_t* begin,
+                                                 const uint8_t* end,
+                                                 const AOBPattern& needle,
+                                                 ScanStrategy strategy = ScanStrategy::Auto) noexcept;
+
+    } // namespace detail
+
+    enum class MatchMode {
+        Overlapping,    // Searching resumes one byte after the start of the previous match.
+        NonOverlapping, // Searching resumes at the end of the previous match.
     };
 
+    // Position at which a pattern matches with mismatches mismatched bytes, see AOBScanner::findApproximate.
+    struct ApproximateMatch {
+        const uint8_t* position;
+        size_t mismatches;
+
+        [[nodiscard]] bool operator==(const ApproximateMatch&) const noexcept = default;
+    };
+
+    template <std::forward_iterator FwdIter>
+    class AOBMatchRange;
+
     class AOBScanner {
     public:
         template <std::forward_iterator FwdIter1>
-        static FwdIter1 find(FwdIter1 haystackBegin, FwdIter1 haystackEnd, const AOBPattern& needle) {
-            return find(haystackBegin, haystackEnd, needle.begin(), needle.end());
+        static FwdIter1 find(FwdIter1 haystackBegin,
+                             FwdIter1 haystackEnd,
+                             const AOBPattern& needle,
+                             ScanStrategy strategy = ScanStrategy::Auto) {
+            if constexpr(std::contiguous_iterator<FwdIter1>) {
+                static_assert(std::is_same_v<typename std::iterator_traits<FwdIter1>::value_type, uint8_t>);
+
+                const auto size = std::distance(haystackBegin, haystackEnd);
+                if(size <= 0)
+                    return haystackEnd;
+
+                const uint8_t* begin = std::to_address(haystackBegin);
+                const uint8_t* match = detail::findPattern(begin, begin + size, needle, strategy);
+                return std::next(haystackBegin, match - begin);
+            } else {
+                auto remaining = std::distance(haystackBegin, haystackEnd);
+                for(; remaining >= static_cast<ptrdiff_t>(needle.size()); ++haystackBegin, --remaining) {
+                    if(needle.matchesAt(haystackBegin))
+                        return haystackBegin;
+                }
+                return haystackEnd;
+            }
         }
 
         template <std::forward_iterator FwdIter1, std::forward_iterator FwdIter2>
@@ -43,6 +427,203 @@ namespace B3L {
 
             return std::search(haystackBegin, haystackEnd, needleBegin, needleEnd, pred);
         }
+
+        template <std::forward_iterator FwdIter, size_t N>
+        static FwdIter find(FwdIter haystackBegin, FwdIter haystackEnd, const StaticAOBPattern<N>& needle) {
+            static_assert(std::is_same_v<typename std::iterator_traits<FwdIter>::value_type, uint8_t>);
+
+            auto remaining = std::distance(haystackBegin, haystackEnd);
+            for(; remaining >= static_cast<ptrdiff_t>(N); ++haystackBegin, --remaining) {
+                if(needle.matchesAt(haystackBegin))
+                    return haystackBegin;
+            }
+            return haystackEnd;
+        }
+
+        // Matcher specialized for the length and wildcard layout of Pattern, e.g. find<"48 8B ?? 05"_aob>(begin, end).
+        template <StaticAOBPattern Pattern, std::forward_iterator FwdIter>
+        static FwdIter find(FwdIter haystackBegin, FwdIter haystackEnd) {
+            static_assert(std::is_same_v<typename std::iterator_traits<FwdIter>::value_type, uint8_t>);
+
+            if constexpr(std::contiguous_iterator<FwdIter>) {
+                constexpr auto size   = Pattern.size();
+                constexpr auto anchor = Pattern.anchor();
+
+                const auto count = std::distance(haystackBegin, haystackEnd);
+                if(count < static_cast<ptrdiff_t>(size))
+                    return haystackEnd;
+
+                const uint8_t* begin = std::to_address(haystackBegin);
+                const uint8_t* last  = begin + (count - size);
+
+                if constexpr(anchor < 0) {
+                    for(auto pos = begin; pos <= last; ++pos) {
+                        if(detail::matchesStaticPattern<Pattern>(pos, std::make_index_sequence<size>{}))
+                            return std::next(haystackBegin, pos - begin);
+                    }
+                    return haystackEnd;
+                } else {
+                    for(auto pos = begin; pos <= last; ++pos) {
+                        auto hit = static_cast<const uint8_t*>(std::memchr(pos + anchor, Pattern.value[anchor], last - pos + 1));
+                        if(!hit)
+                            break;
+
+                        pos = hit - anchor;
+                        if(detail::matchesStaticPattern<Pattern>(pos, std::make_index_sequence<size>{}))
+                            return std::next(haystackBegin, pos - begin);
+                    }
+                    return haystackEnd;
+                }
+            } else {
+                return find(haystackBegin, haystackEnd, Pattern);
+            }
+        }
+
+        // Returns iterator to the begin of the first match of regex or haystackEnd, see AOBRegex::find.
+        template <std::contiguous_iterator FwdIter>
+        static FwdIter find(FwdIter haystackBegin, FwdIter haystackEnd, const AOBRegex& regex) {
+            static_assert(std::is_same_v<typename std::iterator_traits<FwdIter>::value_type, uint8_t>);
+
+            const auto size = std::distance(haystackBegin, haystackEnd);
+            if(size <= 0)
+                return haystackEnd;
+
+            const uint8_t* begin = std::to_address(haystackBegin);
+            const auto match     = regex.find({ begin, static_cast<size_t>(size) });
+            return match ? std::next(haystackBegin, match->begin - begin) : haystackEnd;
+        }
+
+        // Splits the haystack into chunks overlapping by needle.size() - 1 bytes and scans them on threadCount threads.
+        // A threadCount or chunkSize of 0 selects the hardware concurrency and a default chunk size respectively.
+        // Returns pointer to the first match or haystack.data() + haystack.size() if there is none. Workers stop picking up
+        // chunks past the earliest match found so far.
+        [[nodiscard]] static const uint8_t* findParallel(std::span<const uint8_t> haystack,
+                                                         const AOBPattern& needle,
+                                                         unsigned threadCount = 0,
+                                                         size_t chunkSize     = 0);
+
+        // Returns pointers to all matches in address order.
+        [[nodiscard]] static std::vector<const uint8_t*> findAllParallel(std::span<const uint8_t> haystack,
+                                                                         const AOBPattern& needle,
+                                                                         unsigned threadCount = 0,
+                                                                         size_t chunkSize     = 0);
+
+        // Returns all positions at which needle matches with at most maxMismatches mismatched bytes, ordered by the
+        // number of mismatches and then by address. Wildcards never mismatch, partially masked bytes mismatch if any
+        // masked bit differs. Pigeonhole filtered: the masked bytes are split into maxMismatches + 1 pieces, one of
+        // which has to match exactly, so only the exact hits of the pieces are compared in full.
+        [[nodiscard]] static std::vector<ApproximateMatch>
+        findApproximate(std::span<const uint8_t> haystack, const AOBPattern& needle, size_t maxMismatches);
+
+        // Returns a lazy range over all matches. Each increment resumes the search from the previous match.
+        // The needle has to outlive the returned range.
+        template <std::forward_iterator FwdIter>
+        [[nodiscard]] static AOBMatchRange<FwdIter>
+        matches(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode = MatchMode::Overlapping);
+
+        // Returns iterators to all matches.
+        template <std::forward_iterator FwdIter>
+        [[nodiscard]] static std::vector<FwdIter>
+        findAll(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode = MatchMode::Overlapping);
+
+#ifdef __cpp_lib_generator
+        template <std::forward_iterator FwdIter>
+        [[nodiscard]] static std::generator<FwdIter>
+        generateMatches(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode = MatchMode::Overlapping) {
+            for(auto match : matches(haystackBegin, haystackEnd, needle, mode))
+                co_yield match;
+        }
+#endif
     };
 
+    // Forward range of iterators to the matches of a pattern in a haystack.
+    template <std::forward_iterator FwdIter>
+    class AOBMatchRange : public std::ranges::view_interface<AOBMatchRange<FwdIter>> {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = FwdIter;
+            using pointer           = const value_type*;
+            using reference         = const value_type&;
+
+            Iterator() = default;
+            Iterator(FwdIter match, const AOBMatchRange* range) : match(match), range(range) {
+            }
+
+            reference operator*() const {
+                return match;
+            }
+            pointer operator->() const {
+                return &match;
+            }
+
+            Iterator& operator++() {
+                match = range->next(match);
+                return *this;
+            }
+            Iterator operator++(int) {
+                auto old = *this;
+                ++(*this);
+                return old;
+            }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+                return lhs.match == rhs.match;
+            }
+            friend bool operator==(const Iterator& it, std::default_sentinel_t) {
+                return it.atEnd();
+            }
+
+        private:
+            [[nodiscard]] bool atEnd() const {
+                return match == range->haystackEnd;
+            }
+
+            FwdIter match{};
+            const AOBMatchRange* range = nullptr;
+        };
+
+        AOBMatchRange() = default;
+        AOBMatchRange(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode)
+        : haystackBegin(haystackBegin), haystackEnd(haystackEnd), needle(&needle), mode(mode) {
+        }
+
+        // Searches for the first match.
+        [[nodiscard]] Iterator begin() const {
+            return { AOBScanner::find(haystackBegin, haystackEnd, *needle), this };
+        }
+
+        [[nodiscard]] std::default_sentinel_t end() const noexcept {
+            return {};
+        }
+
+    private:
+        FwdIter next(FwdIter match) const {
+            const auto skip = mode == MatchMode::NonOverlapping ? needle->size() : 1;
+            return AOBScanner::find(std::next(match, skip), haystackEnd, *needle);
+        }
+
+        FwdIter haystackBegin{};
+        FwdIter haystackEnd{};
+        const AOBPattern* needle = nullptr;
+        MatchMode mode           = MatchMode::Overlapping;
+    };
+
+    template <std::forward_iterator FwdIter>
+    inline AOBMatchRange<FwdIter>
+    AOBScanner::matches(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode) {
+        return { haystackBegin, haystackEnd, needle, mode };
+    }
+
+    template <std::forward_iterator FwdIter>
+    inline std::vector<FwdIter>
+    AOBScanner::findAll(FwdIter haystackBegin, FwdIter haystackEnd, const AOBPattern& needle, MatchMode mode) {
+        std::vector<FwdIter> result;
+        for(auto match : matches(haystackBegin, haystackEnd, needle, mode))
+            result.push_back(match);
+        return result;
+    }
+
 } // namespace B3L
\ No newline at end of file
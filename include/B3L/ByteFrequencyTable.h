@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace B3L {
+
+    // Relative frequencies of byte values in a kind of data, used to estimate how selective pattern bytes are.
+    class ByteFrequencyTable {
+    public:
+        // Empty table, every byte value is equally likely until data is added.
+        ByteFrequencyTable() = default;
+
+        // Default table for x86-64 machine code.
+        [[nodiscard]] static const ByteFrequencyTable& x86_64() noexcept;
+
+        // Learns the frequencies from sample, e.g. the executable sections of an image.
+        [[nodiscard]] static ByteFrequencyTable fromSample(std::span<const uint8_t> sample) noexcept;
+
+        // Adds the bytes of data to the counts.
+        void add(std::span<const uint8_t> data) noexcept;
+
+        // Probability that a random byte b satisfies (b & mask) == value. Byte values never seen are assumed to occur
+        // once so that estimates stay non zero.
+        [[nodiscard]] double matchProbability(uint8_t value, uint8_t mask = 0xFF) const noexcept;
+
+    private:
+        explicit ByteFrequencyTable(const std::array<uint64_t, 256>& counts) noexcept;
+
+        std::array<uint64_t, 256> counts{};
+        uint64_t total = 0;
+    };
+
+} // namespace B3L
@@ -0,0 +1,71 @@
+#pragma once
+#include "AOBScanner.h"
+#include "ByteFrequencyTable.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace B3L {
+
+    // AOBPattern prepared for repeated scans. Anchors are chosen by their estimated match probability in the target
+    // data and the scan strategy is fixed at compile time, so scans don't repeat any per pattern setup.
+    class CompiledPattern {
+    public:
+        // Selects the rarest pattern bytes according to frequencies as anchors. ScanStrategy::Auto picks Horspool if
+        // its expected shift beats the anchor compare, i.e. for exact suffixes of uncommon bytes of ~64 bytes and up.
+        [[nodiscard]] static CompiledPattern compile(AOBPattern pattern,
+                                                     const ByteFrequencyTable& frequencies = ByteFrequencyTable::x86_64(),
+                                                     ScanStrategy strategy                 = ScanStrategy::Auto);
+
+        [[nodiscard]] const AOBPattern& pattern() const noexcept {
+            return needle;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return needle.size();
+        }
+
+        // Resolved strategy, never ScanStrategy::Auto.
+        [[nodiscard]] ScanStrategy strategy() const noexcept {
+            return _strategy;
+        }
+
+        [[nodiscard]] int primaryAnchor() const noexcept {
+            return _primaryAnchor;
+        }
+
+        [[nodiscard]] int secondaryAnchor() const noexcept {
+            return _secondaryAnchor;
+        }
+
+        // Horspool shift for each value of the last byte of the window. Only meaningful for ScanStrategy::Horspool.
+        [[nodiscard]] std::span<const uint32_t, 256> skipTable() const noexcept {
+            return skip;
+        }
+
+        // Estimated probability that the pattern matches at a random position.
+        [[nodiscard]] double matchProbability() const noexcept {
+            return _matchProbability;
+        }
+
+        // Returns pointer to the first match in [begin, end) or end if there is none.
+        [[nodiscard]] const uint8_t* find(const uint8_t* begin, const uint8_t* end) const noexcept;
+
+        // Returns pointers to all overlapping matches.
+        [[nodiscard]] std::vector<const uint8_t*> findAll(std::span<const uint8_t> haystack) const;
+
+    private:
+        explicit CompiledPattern(AOBPattern pattern) : needle(std::move(pattern)) {
+        }
+
+        AOBPattern needle;
+        ScanStrategy _strategy = ScanStrategy::Anchor;
+        int _primaryAnchor     = -1;
+        int _secondaryAnchor   = -1;
+        std::array<uint32_t, 256> skip{};
+        double _matchProbability = 1.0;
+    };
+
+} // namespace B3L
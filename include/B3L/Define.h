@@ -36,7 +36,7 @@ public:                                       \
         #define B3L_NO_UNIQUE_ADDRESS
     #endif
 #else
-    #define B3L_FORCEINLINE __attribute__((always_inline))
+    #define B3L_FORCEINLINE inline __attribute__((always_inline))
     #define B3L_NEVERINLINE __attribute__((noinline))
     #define B3L_NO_UNIQUE_ADDRESS [[no_unique_address]]
 #endif
@@ -0,0 +1,66 @@
+#pragma once
+#include "Define.h"
+#include "Hash.h"
+#include "ImageView.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace B3L {
+
+    // Export lookups of an image by name, name hash and ordinal. Names are hashed into an open addressing table on
+    // the first query, which makes each lookup O(1) instead of a search through AddressOfNames. Building is thread
+    // safe, the index has to outlive the exports it returns.
+    class ExportIndex {
+        B3L_MAKE_NONCOPYABLE(ExportIndex);
+
+    public:
+        explicit ExportIndex(const ImageView& image) noexcept : image(image), directory(this->image.exportDirectory()) {
+        }
+
+        // Hash used for names, can be evaluated at compile time through nameHash.
+        [[nodiscard]] static constexpr uint64_t hash(std::string_view name) noexcept {
+            return Hash::fnv1a(name);
+        }
+
+        template <size_t N>
+        [[nodiscard]] static consteval uint64_t nameHash(const char (&name)[N]) noexcept {
+            return hash({ name, N - 1 });
+        }
+
+        [[nodiscard]] std::optional<ImageView::Export> find(std::string_view name) const;
+
+        // Looks up an export by the hash of its name, e.g. find(ExportIndex::nameHash("VirtualAlloc")). Names are not
+        // compared, the first export with a matching hash is returned.
+        [[nodiscard]] std::optional<ImageView::Export> findByHash(uint64_t nameHash) const;
+
+        [[nodiscard]] std::optional<ImageView::Export> findByOrdinal(uint32_t ordinal) const;
+
+        // Number of exports with a name.
+        [[nodiscard]] size_t nameCount() const noexcept;
+
+    private:
+        struct Slot {
+            uint64_t hash      = 0;
+            uint32_t nameIndex = ImageView::Export::noName; // Empty if noName
+        };
+
+        void build() const;
+
+        template <typename Matches>
+        [[nodiscard]] std::optional<ImageView::Export> probe(uint64_t nameHash, Matches&& matches) const;
+
+        [[nodiscard]] ImageView::Export makeExport(uint32_t functionIndex, uint32_t nameIndex) const noexcept;
+
+        ImageView image;
+        const PE::ExportDirectory* directory = nullptr;
+
+        mutable std::once_flag built;
+        mutable std::vector<Slot> slots;             // Capacity is a power of two
+        mutable std::vector<uint32_t> functionNames; // Name index of each function or noName
+    };
+
+} // namespace B3L
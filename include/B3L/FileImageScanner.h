@@ -0,0 +1,25 @@
+#pragma once
+#include "AOBScanner.h"
+#include "FileImageView.h"
+#include "SectionFilter.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace B3L {
+
+    // Scans the sections of a FileImageView in place. Matches are returned as RVAs, which stay valid for any load
+    // address of the image.
+    class FileImageScanner {
+    public:
+        // Returns the RVA of the first match in section order.
+        [[nodiscard]] static std::optional<uint32_t>
+        find(const FileImageView& image, const AOBPattern& needle, const SectionFilter& filter = {});
+
+        // Returns the RVAs of all matches in section order. Sections are scanned on up to threadCount threads,
+        // a threadCount of 0 selects the hardware concurrency.
+        [[nodiscard]] static std::vector<uint32_t>
+        findAll(const FileImageView& image, const AOBPattern& needle, const SectionFilter& filter = {}, unsigned threadCount = 1);
+    };
+
+} // namespace B3L
@@ -0,0 +1,117 @@
+#pragma once
+#include "PE.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace B3L {
+
+    // View of a PE file in its on-disk layout, e.g. the contents of a MappedFile. Does not depend on the Windows
+    // headers and never copies image data. RVAs are translated to file offsets through the section table.
+    class FileImageView {
+    public:
+        // Creates a structurally validated view. Returns nullopt if data is not a PE file or any header or section
+        // raw data lies outside of data.
+        [[nodiscard]] static std::optional<FileImageView> create(std::span<const uint8_t> data);
+
+        [[nodiscard]] std::span<const uint8_t> data() const noexcept {
+            return file;
+        }
+
+        [[nodiscard]] const PE::DosHeader* dosHeader() const noexcept {
+            return reinterpret_cast<const PE::DosHeader*>(file.data());
+        }
+
+        [[nodiscard]] const PE::FileHeader* fileHeader() const noexcept {
+            return reinterpret_cast<const PE::FileHeader*>(file.data() + dosHeader()->e_lfanew + sizeof(uint32_t));
+        }
+
+        [[nodiscard]] bool is64Bit() const noexcept {
+            return optionalHeader32()->Magic == PE::optionalHeader64Magic;
+        }
+
+        // Both optional header layouts share their first fields up to and including AddressOfEntryPoint.
+        [[nodiscard]] const PE::OptionalHeader32* optionalHeader32() const noexcept {
+            return reinterpret_cast<const PE::OptionalHeader32*>(fileHeader() + 1);
+        }
+
+        [[nodiscard]] const PE::OptionalHeader64* optionalHeader64() const noexcept {
+            return reinterpret_cast<const PE::OptionalHeader64*>(fileHeader() + 1);
+        }
+
+        [[nodiscard]] uint64_t preferredImageBase() const noexcept {
+            return is64Bit() ? optionalHeader64()->ImageBase : optionalHeader32()->ImageBase;
+        }
+
+        [[nodiscard]] uint32_t sizeOfImage() const noexcept {
+            return is64Bit() ? optionalHeader64()->SizeOfImage : optionalHeader32()->SizeOfImage;
+        }
+
+        [[nodiscard]] uint32_t timestamp() const noexcept {
+            return fileHeader()->TimeDateStamp;
+        }
+
+        // Returns nullptr if the image has no entry for index.
+        [[nodiscard]] const PE::DataDirectory* dataDirectory(int index) const noexcept;
+
+        [[nodiscard]] int sectionCount() const noexcept {
+            return fileHeader()->NumberOfSections;
+        }
+
+        // Returns pointer to first section header. Iterating up to sectionCount() is guaranteed to be safe.
+        [[nodiscard]] const PE::SectionHeader* sections() const noexcept {
+            return reinterpret_cast<const PE::SectionHeader*>(reinterpret_cast<const uint8_t*>(fileHeader() + 1) +
+                                                              fileHeader()->SizeOfOptionalHeader);
+        }
+
+        [[nodiscard]] const PE::SectionHeader* section(int index) const noexcept {
+            if(index < 0 || index >= sectionCount())
+                return nullptr;
+
+            return sections() + index;
+        }
+
+        // Section names are padded with null bytes but not null terminated if they are exactly 8 characters long.
+        [[nodiscard]] std::string_view sectionName(int index) const noexcept {
+            auto header = section(index);
+            if(!header)
+                return {};
+
+            auto name = reinterpret_cast<const char*>(header->Name);
+            return { name, std::find(name, name + PE::sizeOfShortName, '\0') };
+        }
+
+        // Returns the initialized data of a section as stored in the file. Trailing zero fill of the mapped section
+        // is not part of the file and therefore not included.
+        [[nodiscard]] std::span<const uint8_t> sectionData(int index) const noexcept;
+
+        // Translates an RVA to a file offset. Returns nullopt if the RVA is not backed by file data.
+        [[nodiscard]] std::optional<size_t> RVAtoOffset(uint64_t rva) const noexcept;
+
+        // Translates a file offset to an RVA. Returns nullopt if the offset is not part of the headers or a section.
+        [[nodiscard]] std::optional<uint32_t> offsetToRVA(size_t offset) const noexcept;
+
+        // Returns nullptr if the RVA is not backed by file data.
+        template <typename To>
+        [[nodiscard]] To RVAtoPointer(uint64_t rva) const noexcept {
+            static_assert(std::is_pointer_v<To>);
+            auto offset = RVAtoOffset(rva);
+            return offset ? reinterpret_cast<To>(file.data() + *offset) : nullptr;
+        }
+
+    private:
+        explicit FileImageView(std::span<const uint8_t> data) : file(data) {
+        }
+
+        [[nodiscard]] uint32_t sizeOfHeaders() const noexcept {
+            return is64Bit() ? optionalHeader64()->SizeOfHeaders : optionalHeader32()->SizeOfHeaders;
+        }
+
+        std::span<const uint8_t> file;
+    };
+
+} // namespace B3L
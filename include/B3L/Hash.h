@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace B3L {
+    namespace Hash {
+
+        constexpr uint64_t fnv1aOffsetBasis = 0xCBF29CE484222325;
+        constexpr uint64_t fnv1aPrime       = 0x100000001B3;
+
+        // 64 bit FNV-1a. Pass a previous result as seed to hash discontiguous data.
+        [[nodiscard]] constexpr uint64_t fnv1a(std::span<const uint8_t> data, uint64_t seed = fnv1aOffsetBasis) noexcept {
+            for(auto b : data) {
+                seed ^= b;
+                seed *= fnv1aPrime;
+            }
+            return seed;
+        }
+
+        [[nodiscard]] constexpr uint64_t fnv1a(std::string_view str, uint64_t seed = fnv1aOffsetBasis) noexcept {
+            for(auto c : str) {
+                seed ^= static_cast<uint8_t>(c);
+                seed *= fnv1aPrime;
+            }
+            return seed;
+        }
+
+        // fnv1a of str with ASCII letters folded to lower case, for names that compare case-insensitively.
+        [[nodiscard]] constexpr uint64_t fnv1aLower(std::string_view str, uint64_t seed = fnv1aOffsetBasis) noexcept {
+            for(auto c : str) {
+                seed ^= static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+                seed *= fnv1aPrime;
+            }
+            return seed;
+        }
+
+        // Hashes the object representation of a trivially copyable value.
+        template <typename T>
+        [[nodiscard]] uint64_t fnv1aValue(const T& value, uint64_t seed = fnv1aOffsetBasis) noexcept {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return fnv1a({ reinterpret_cast<const uint8_t*>(&value), sizeof(value) }, seed);
+        }
+
+    } // namespace Hash
+} // namespace B3L
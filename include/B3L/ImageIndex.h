@@ -0,0 +1,91 @@
+#pragma once
+#include "AOBScanner.h"
+#include "FileImageView.h"
+#include "SectionFilter.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+    class ImageView;
+
+    // Suffix array index over the sections of an image for repeated queries against the same bytes. Building costs
+    // a linear pass per section, after which exact queries take O(needle size + log section size + occurrences)
+    // instead of a scan. Patterns with wildcards are answered through their solid (fully masked) fragments: the
+    // fragment with the fewest occurrences provides the candidates, which are verified against the whole pattern.
+    class ImageIndex {
+    public:
+        struct Section {
+            uint64_t address;
+            std::span<const uint8_t> data;
+        };
+
+        // Indexes sections on up to threadCount threads, a threadCount of 0 selects the hardware concurrency.
+        // Section data has to outlive the index. Throws std::length_error if a section exceeds 2 GiB.
+        explicit ImageIndex(std::vector<Section> sections, unsigned threadCount = 0);
+
+        // Indexes the sections of a mapped image accepted by filter, addresses are virtual addresses.
+        [[nodiscard]] static ImageIndex fromImage(const ImageView& image, const SectionFilter& filter = {}, unsigned threadCount = 0);
+
+        // Indexes the sections of a file image accepted by filter, addresses are RVAs like those of FileImageScanner.
+        [[nodiscard]] static ImageIndex fromFile(const FileImageView& image, const SectionFilter& filter = {}, unsigned threadCount = 0);
+
+        // Restores an index written by save() for the same sections. Returns nullopt if the file is missing or
+        // malformed or the sections differ in address, size or contents from those that were indexed.
+        [[nodiscard]] static std::optional<ImageIndex> load(const std::filesystem::path& path, std::vector<Section> sections);
+
+        // Writes the suffix arrays along with a hash of each section and of each suffix array. The file is replaced
+        // once it was written completely. Throws on IO failure.
+        void save(const std::filesystem::path& path) const;
+
+        // Returns the address of the first match in address order.
+        [[nodiscard]] std::optional<uint64_t> find(std::span<const uint8_t> needle) const;
+        [[nodiscard]] std::optional<uint64_t> find(const AOBPattern& needle) const;
+
+        // Returns the addresses of all matches in ascending order.
+        [[nodiscard]] std::vector<uint64_t> findAll(std::span<const uint8_t> needle) const;
+        [[nodiscard]] std::vector<uint64_t> findAll(const AOBPattern& needle) const;
+
+        // Number of occurrences of needle, without enumerating them.
+        [[nodiscard]] size_t count(std::span<const uint8_t> needle) const;
+
+        [[nodiscard]] std::span<const Section> sections() const noexcept {
+            return indexed;
+        }
+
+    private:
+        // Suffixes of a section in lexicographical order.
+        using SuffixArray = std::vector<uint32_t>;
+
+        struct Range {
+            size_t first;
+            size_t last;
+
+            [[nodiscard]] size_t size() const noexcept {
+                return last - first;
+            }
+        };
+
+        ImageIndex(std::vector<Section> sections, std::vector<SuffixArray> suffixArrays) noexcept;
+
+        // Range of the suffix array of section whose suffixes start with needle.
+        [[nodiscard]] Range equalRange(size_t section, std::span<const uint8_t> needle) const noexcept;
+
+        // Unordered offsets of all matches within section.
+        [[nodiscard]] std::vector<uint32_t> matches(size_t section, std::span<const uint8_t> needle) const;
+        [[nodiscard]] std::vector<uint32_t> matches(size_t section, const AOBPattern& needle) const;
+
+        template <typename Needle>
+        [[nodiscard]] std::optional<uint64_t> firstMatch(const Needle& needle) const;
+        template <typename Needle>
+        [[nodiscard]] std::vector<uint64_t> allMatches(const Needle& needle) const;
+
+        std::vector<Section> indexed;
+        std::vector<SuffixArray> suffixArrays; // One per section
+    };
+
+} // namespace B3L
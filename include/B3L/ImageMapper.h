@@ -0,0 +1,63 @@
+#pragma once
+#include "Define.h"
+#include "ImageView.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+
+namespace B3L {
+    class FileImageView;
+
+    // Maps a PE file into private memory in its runtime layout without the loader, i.e. without running any of its
+    // code, loading its dependencies or registering it with the process. Mapped images are relocated to the address
+    // they are mapped at and their IAT is filled through an optional resolver. All memory stays readable and writable.
+    // Only images matching the process architecture can be mapped, ImageView requires the native layout.
+    class ImageMapper {
+        B3L_MAKE_NONCOPYABLE(ImageMapper);
+
+    public:
+        // Returns the value of the IAT entry of import.
+        using ImportResolver = std::function<uintptr_t(const ImageView::Import& import)>;
+
+        // Maps the file at path. On Linux, sections whose raw data is page aligned in the file are mapped copy on write
+        // from the file instead of being copied. Throws std::system_error if the file can't be read or memory can't be
+        // allocated and std::runtime_error if the file is not a valid image. Imports keep their on-disk values if
+        // resolver is empty.
+        explicit ImageMapper(const std::filesystem::path& path, const ImportResolver& resolver = {});
+
+        // Maps an image from the contents of a file, sections are always copied.
+        explicit ImageMapper(std::span<const uint8_t> file, const ImportResolver& resolver = {});
+
+        ImageMapper(ImageMapper&& other) noexcept;
+        ImageMapper& operator=(ImageMapper&& other) noexcept;
+        ~ImageMapper();
+
+        [[nodiscard]] const ImageView& view() const noexcept {
+            return *image;
+        }
+
+        [[nodiscard]] uint8_t* data() const noexcept {
+            return mapping;
+        }
+
+        // SizeOfImage of the mapped image.
+        [[nodiscard]] size_t size() const noexcept {
+            return length;
+        }
+
+    private:
+        // Sections may be mapped from fileDescriptor if it isn't -1, which it always is on Windows.
+        void map(std::span<const uint8_t> file, int fileDescriptor, const ImportResolver& resolver);
+        void mapSection(const FileImageView& file, int index, int fileDescriptor);
+
+        void unmap() noexcept;
+
+        uint8_t* mapping = nullptr;
+        size_t length    = 0;
+        std::optional<ImageView> image;
+    };
+
+} // namespace B3L
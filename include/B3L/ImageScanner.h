@@ -0,0 +1,24 @@
+#pragma once
+#include "AOBScanner.h"
+#include "ImageView.h"
+#include "SectionFilter.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace B3L {
+
+    // Scans the sections of an ImageView. Matches are returned as virtual addresses.
+    class ImageScanner {
+    public:
+        // Returns the address of the first match in section order.
+        [[nodiscard]] static std::optional<uintptr_t>
+        find(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter = {});
+
+        // Returns the addresses of all matches in section order. Sections are scanned on up to threadCount threads,
+        // a threadCount of 0 selects the hardware concurrency.
+        [[nodiscard]] static std::vector<uintptr_t>
+        findAll(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter = {}, unsigned threadCount = 1);
+    };
+
+} // namespace B3L
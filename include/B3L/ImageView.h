@@ -1,44 +1,59 @@
 #pragma once
 #include "Cast.h"
-#include <Windows.h>
+#include "MemoryQuery.h"
+#include "PE.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <iterator>
 #include <optional>
 #include <span>
+#include <string>
+#include <string_view>
 
 namespace B3L {
+    class ExportIndex;
+
+    // View of a PE image mapped into the current process, laid out by virtual address. Uses the platform independent
+    // structures of PE.h in the layout of the current process, i.e. PE32+ in 64 bit processes.
     class ImageView {
     public:
         class SectionView;
         class Import;
         class ImportIterator;
+        class Export;
+        class ExportIterator;
+        class RelocationBlock;
+        class RelocationIterator;
 
-        // Creates structurally validated ImageView from mapped Image. Throws on failure.
-        [[nodiscard]] static std::optional<ImageView> createFromMappedImage(const uint8_t* data);
+        // Creates structurally validated ImageView from mapped Image. Returns nullopt if the headers are invalid or
+        // memory describes the sections as not mapped.
+        [[nodiscard]] static std::optional<ImageView> createFromMappedImage(const uint8_t* data,
+                                                                           const MemoryQuery& memory = MemoryQuery::native());
 
         [[nodiscard]] inline uintptr_t baseAddress() const noexcept {
             return rcast<uintptr_t>(imageBase);
         }
 
-        [[nodiscard]] inline const IMAGE_DOS_HEADER* dosHeader() const noexcept {
-            return rcast<const IMAGE_DOS_HEADER*>(imageBase);
+        [[nodiscard]] inline const PE::DosHeader* dosHeader() const noexcept {
+            return rcast<const PE::DosHeader*>(imageBase);
         }
 
-        [[nodiscard]] inline const IMAGE_NT_HEADERS* ntHeaders() const noexcept {
-            return rcast<const IMAGE_NT_HEADERS*>(imageBase + dosHeader()->e_lfanew);
+        [[nodiscard]] inline const PE::NtHeaders* ntHeaders() const noexcept {
+            return rcast<const PE::NtHeaders*>(imageBase + dosHeader()->e_lfanew);
         }
 
-        [[nodiscard]] inline const IMAGE_OPTIONAL_HEADER* optionalHeader() const noexcept {
+        [[nodiscard]] inline const PE::OptionalHeader* optionalHeader() const noexcept {
             return &ntHeaders()->OptionalHeader;
         }
 
-        [[nodiscard]] inline const IMAGE_FILE_HEADER* fileHeader() const noexcept {
+        [[nodiscard]] inline const PE::FileHeader* fileHeader() const noexcept {
             return &ntHeaders()->FileHeader;
         }
 
-        [[nodiscard]] inline const IMAGE_DATA_DIRECTORY* dataDirectory(int index) const noexcept {
+        [[nodiscard]] inline const PE::DataDirectory* dataDirectory(int index) const noexcept {
             assert(index >= 0);
-            assert(index < IMAGE_NUMBEROF_DIRECTORY_ENTRIES);
+            assert(index < PE::numberOfDirectoryEntries);
 
             return &optionalHeader()->DataDirectory[index];
         }
@@ -48,15 +63,15 @@ namespace B3L {
         }
 
         // Returns pointer to first section header. Iterating up to sectionCount() is guaranteed to be safe.
-        [[nodiscard]] inline const IMAGE_SECTION_HEADER* sections() const noexcept {
+        [[nodiscard]] inline const PE::SectionHeader* sections() const noexcept {
             const auto nth              = ntHeaders();
             const auto sectionHeaderOff = rcast<const uint8_t*>(nth) + sizeof(nth->Signature) +
                                           sizeof(nth->FileHeader) + nth->FileHeader.SizeOfOptionalHeader;
 
-            return rcast<const IMAGE_SECTION_HEADER*>(sectionHeaderOff);
+            return rcast<const PE::SectionHeader*>(sectionHeaderOff);
         }
 
-        [[nodiscard]] inline const IMAGE_SECTION_HEADER* section(int index) const noexcept {
+        [[nodiscard]] inline const PE::SectionHeader* section(int index) const noexcept {
             const auto cnt = sectionCount();
             if(index < 0 || index >= cnt)
                 return nullptr;
@@ -64,6 +79,16 @@ namespace B3L {
             return sections() + index;
         }
 
+        // Section names are padded with null bytes but not null terminated if they are exactly 8 characters long.
+        [[nodiscard]] std::string_view sectionName(int index) const noexcept {
+            auto header = section(index);
+            if(!header)
+                return {};
+
+            auto name = rcast<const char*>(header->Name);
+            return { name, std::find(name, name + PE::sizeOfShortName, '\0') };
+        }
+
         [[nodiscard]] std::span<const uint8_t> sectionData(int index) const noexcept {
             if(sectionCount() <= index)
                 return {};
@@ -82,6 +107,23 @@ namespace B3L {
         [[nodiscard]] inline ImportIterator importsBegin() const noexcept;
         [[nodiscard]] inline ImportIterator importsEnd() const noexcept;
 
+        // Returns nullptr if the image has no exports.
+        [[nodiscard]] inline const PE::ExportDirectory* exportDirectory() const noexcept {
+            const auto exportDir = dataDirectory(PE::DirectoryEntry::Export);
+            if(!exportDir->VirtualAddress || !exportDir->Size)
+                return nullptr;
+
+            return RVAtoVA<const PE::ExportDirectory*>(exportDir->VirtualAddress);
+        }
+
+        // Iterates the exports with a name in name order, see ExportIndex for lookups.
+        [[nodiscard]] inline ExportIterator exportsBegin() const noexcept;
+        [[nodiscard]] inline ExportIterator exportsEnd() const noexcept;
+
+        // Iterates the blocks of the base relocation directory, one per page. Iteration ends early at a malformed block.
+        [[nodiscard]] inline RelocationIterator relocationsBegin() const noexcept;
+        [[nodiscard]] inline RelocationIterator relocationsEnd() const noexcept;
+
         template <typename To>
         [[nodiscard]] inline To RVAtoVA(uint64_t rva) const noexcept {
             static_assert(std::is_pointer_v<To>);
@@ -95,7 +137,7 @@ namespace B3L {
         static void validateHeaderStructure(const ImageView& view, size_t maxHeaderSize);
 
         // Validates that virtual memory of the correct size and at the correct location has been allocated for all sections as described in the corresponding section headers.
-        static void validateMappedSectionStructure(const ImageView& view);
+        static void validateMappedSectionStructure(const ImageView& view, const MemoryQuery& memory);
 
         const uint8_t* imageBase;
     };
@@ -107,7 +149,7 @@ namespace B3L {
         }
 
         [[nodiscard]] bool importedByOrdinal() const noexcept {
-            return IMAGE_SNAP_BY_ORDINAL(originalFirstThunk->u1.Ordinal);
+            return (originalFirstThunk->u1.Ordinal & PE::ordinalFlag) != 0;
         }
 
         [[nodiscard]] const char* moduleName() const noexcept {
@@ -118,7 +160,7 @@ namespace B3L {
             if(!importedByName())
                 return "";
 
-            auto importByName = image->RVAtoVA<const IMAGE_IMPORT_BY_NAME*>(originalFirstThunk->u1.AddressOfData);
+            auto importByName = image->RVAtoVA<const PE::ImportByName*>(originalFirstThunk->u1.AddressOfData);
             return importByName->Name;
         }
 
@@ -126,7 +168,7 @@ namespace B3L {
             if(!importedByOrdinal())
                 return -1;
 
-            return IMAGE_ORDINAL(originalFirstThunk->u1.Ordinal);
+            return static_cast<int>(originalFirstThunk->u1.Ordinal & 0xFFFF);
         }
 
         [[nodiscard]] const uintptr_t* IATEntryAddress() const noexcept {
@@ -138,10 +180,10 @@ namespace B3L {
     private:
         friend class ImageView::ImportIterator;
 
-        const IMAGE_IMPORT_DESCRIPTOR* importDescriptor = nullptr;
-        const IMAGE_THUNK_DATA* originalFirstThunk      = nullptr;
-        const IMAGE_THUNK_DATA* firstThunk              = nullptr;
-        const ImageView* image                          = nullptr;
+        const PE::ImportDescriptor* importDescriptor = nullptr;
+        const PE::ThunkData* originalFirstThunk      = nullptr;
+        const PE::ThunkData* firstThunk              = nullptr;
+        const ImageView* image                       = nullptr;
     };
 
     class ImageView::ImportIterator {
@@ -152,11 +194,19 @@ namespace B3L {
         using pointer           = value_type*;
         using reference         = value_type&;
 
+        // Equals the end iterator if image has no imports.
         explicit ImportIterator(const ImageView& image) {
-            const auto importDir    = image.dataDirectory(IMAGE_DIRECTORY_ENTRY_IMPORT);
-            desc.importDescriptor   = image.RVAtoVA<const IMAGE_IMPORT_DESCRIPTOR*>(importDir->VirtualAddress);
-            desc.originalFirstThunk = image.RVAtoVA<const IMAGE_THUNK_DATA*>(desc.importDescriptor->OriginalFirstThunk);
-            desc.firstThunk         = image.RVAtoVA<const IMAGE_THUNK_DATA*>(desc.importDescriptor->FirstThunk);
+            const auto importDir = image.dataDirectory(PE::DirectoryEntry::Import);
+            if(!importDir->VirtualAddress || !importDir->Size)
+                return;
+
+            const auto importDescriptor = image.RVAtoVA<const PE::ImportDescriptor*>(importDir->VirtualAddress);
+            if(!importDescriptor->Name)
+                return;
+
+            desc.importDescriptor   = importDescriptor;
+            desc.originalFirstThunk = image.RVAtoVA<const PE::ThunkData*>(desc.importDescriptor->OriginalFirstThunk);
+            desc.firstThunk         = image.RVAtoVA<const PE::ThunkData*>(desc.importDescriptor->FirstThunk);
             desc.image              = &image;
         }
         ImportIterator()                                     = default;
@@ -201,8 +251,8 @@ namespace B3L {
         if(!desc.originalFirstThunk->u1.Ordinal) {
             desc.importDescriptor++;
             if(desc.importDescriptor->Name) {
-                desc.originalFirstThunk = desc.image->RVAtoVA<const IMAGE_THUNK_DATA*>(desc.importDescriptor->OriginalFirstThunk);
-                desc.firstThunk = desc.image->RVAtoVA<const IMAGE_THUNK_DATA*>(desc.importDescriptor->FirstThunk);
+                desc.originalFirstThunk = desc.image->RVAtoVA<const PE::ThunkData*>(desc.importDescriptor->OriginalFirstThunk);
+                desc.firstThunk = desc.image->RVAtoVA<const PE::ThunkData*>(desc.importDescriptor->FirstThunk);
             } else {
                 desc.importDescriptor   = nullptr;
                 desc.originalFirstThunk = nullptr;
@@ -214,7 +264,7 @@ namespace B3L {
     }
 
     inline ImageView::ImportIterator ImageView::ImportIterator::operator++(int) {
-        ImageView::ImportIterator old;
+        auto old = *this;
         ++(*this);
         return old;
     }
@@ -235,17 +285,228 @@ namespace B3L {
         return {};
     }
 
-    namespace detail { // TODO: Reimplement with IMageView
+    // Entry of the export address table.
+    class ImageView::Export {
+    public:
+        [[nodiscard]] bool exportedByName() const noexcept {
+            return nameIndex != noName;
+        }
+
+        // Returns an empty string for exports by ordinal only.
+        [[nodiscard]] const char* name() const noexcept {
+            if(!exportedByName())
+                return "";
+
+            return image->RVAtoVA<const char*>(image->RVAtoVA<const uint32_t*>(directory->AddressOfNames)[nameIndex]);
+        }
+
+        [[nodiscard]] uint32_t ordinal() const noexcept {
+            return directory->Base + functionIndex;
+        }
+
+        [[nodiscard]] uint32_t rva() const noexcept {
+            return image->RVAtoVA<const uint32_t*>(directory->AddressOfFunctions)[functionIndex];
+        }
+
+        // Forwarded exports refer to an export of another module. Their RVA points to a string within the export
+        // directory such as "NTDLL.RtlAllocateHeap" instead of code or data.
+        [[nodiscard]] bool isForwarded() const noexcept {
+            const auto exportDir = image->dataDirectory(PE::DirectoryEntry::Export);
+            return rva() - exportDir->VirtualAddress < exportDir->Size;
+        }
+
+        // Returns nullptr if the export isn't forwarded.
+        [[nodiscard]] const char* forwarder() const noexcept {
+            return isForwarded() ? image->RVAtoVA<const char*>(rva()) : nullptr;
+        }
+
+        [[nodiscard]] uintptr_t address() const noexcept {
+            return image->baseAddress() + rva();
+        }
+
+        [[nodiscard]] auto operator<=>(const Export&) const noexcept = default;
+
+    private:
+        friend class ImageView::ExportIterator;
+        friend class ExportIndex;
+
+        static constexpr uint32_t noName = UINT32_MAX;
+
+        const PE::ExportDirectory* directory = nullptr;
+        const ImageView* image               = nullptr;
+        uint32_t functionIndex               = 0;
+        uint32_t nameIndex                   = noName; // Index into AddressOfNames
+    };
+
+    class ImageView::ExportIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = Export;
+        using pointer           = value_type*;
+        using reference         = value_type&;
+
+        // Equals the end iterator if image has no named exports.
+        explicit ExportIterator(const ImageView& image) {
+            const auto directory = image.exportDirectory();
+            if(!directory || !directory->NumberOfNames)
+                return;
+
+            desc.directory     = directory;
+            desc.image         = &image;
+            desc.nameIndex     = 0;
+            desc.functionIndex = image.RVAtoVA<const uint16_t*>(directory->AddressOfNameOrdinals)[0];
+        }
+        ExportIterator() = default;
+
+        ExportIterator& operator++() {
+            if(++desc.nameIndex < desc.directory->NumberOfNames) {
+                desc.functionIndex = desc.image->RVAtoVA<const uint16_t*>(desc.directory->AddressOfNameOrdinals)[desc.nameIndex];
+            } else {
+                desc = {};
+            }
+            return *this;
+        }
+
+        ExportIterator operator++(int) {
+            auto old = *this;
+            ++(*this);
+            return old;
+        }
+
+        const value_type& operator*() const {
+            return desc;
+        }
+
+        const value_type* operator->() const {
+            return &desc;
+        }
+
+        friend bool operator==(const ExportIterator& lhs, const ExportIterator& rhs) {
+            return lhs.desc == rhs.desc;
+        }
+
+    private:
+        Export desc{};
+    };
+
+    static_assert(std::forward_iterator<ImageView::ExportIterator>);
+
+    [[nodiscard]] inline ImageView::ExportIterator ImageView::exportsBegin() const noexcept {
+        return ImageView::ExportIterator{ *this };
+    }
+    [[nodiscard]] inline ImageView::ExportIterator ImageView::exportsEnd() const noexcept {
+        return {};
+    }
+
+    // Block of base relocations for a single page.
+    class ImageView::RelocationBlock {
+    public:
+        [[nodiscard]] static constexpr int type(uint16_t entry) noexcept {
+            return entry >> 12;
+        }
+
+        // Offset of the relocated field within the page.
+        [[nodiscard]] static constexpr uint32_t offset(uint16_t entry) noexcept {
+            return entry & 0xFFF;
+        }
+
+        [[nodiscard]] uint32_t pageRVA() const noexcept {
+            return header->VirtualAddress;
+        }
+
+        // Entries hold the relocation type in the upper 4 bits and the offset in the lower 12 bits.
+        [[nodiscard]] std::span<const uint16_t> entries() const noexcept {
+            return { rcast<const uint16_t*>(header + 1), (header->SizeOfBlock - sizeof(PE::BaseRelocation)) / sizeof(uint16_t) };
+        }
+
+        [[nodiscard]] auto operator<=>(const RelocationBlock&) const noexcept = default;
+
+    private:
+        friend class ImageView::RelocationIterator;
+
+        const PE::BaseRelocation* header = nullptr;
+        const uint8_t* directoryEnd      = nullptr;
+    };
+
+    class ImageView::RelocationIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = RelocationBlock;
+        using pointer           = value_type*;
+        using reference         = value_type&;
+
+        // Equals the end iterator if image has no relocations.
+        explicit RelocationIterator(const ImageView& image) {
+            const auto relocDir = image.dataDirectory(PE::DirectoryEntry::BaseReloc);
+            if(!relocDir->VirtualAddress || !relocDir->Size)
+                return;
+
+            desc.header       = image.RVAtoVA<const PE::BaseRelocation*>(relocDir->VirtualAddress);
+            desc.directoryEnd = rcast<const uint8_t*>(desc.header) + relocDir->Size;
+            validate();
+        }
+        RelocationIterator() = default;
+
+        RelocationIterator& operator++() {
+            desc.header = rcast<const PE::BaseRelocation*>(rcast<const uint8_t*>(desc.header) + desc.header->SizeOfBlock);
+            validate();
+            return *this;
+        }
+
+        RelocationIterator operator++(int) {
+            auto old = *this;
+            ++(*this);
+            return old;
+        }
+
+        const value_type& operator*() const {
+            return desc;
+        }
+
+        const value_type* operator->() const {
+            return &desc;
+        }
+
+        friend bool operator==(const RelocationIterator& lhs, const RelocationIterator& rhs) {
+            return lhs.desc == rhs.desc;
+        }
+
+    private:
+        // Ends iteration unless the current block lies within the directory.
+        void validate() noexcept {
+            const auto remaining = desc.directoryEnd - rcast<const uint8_t*>(desc.header);
+            if(remaining < static_cast<std::ptrdiff_t>(sizeof(PE::BaseRelocation)) ||
+               desc.header->SizeOfBlock < sizeof(PE::BaseRelocation) || desc.header->SizeOfBlock > remaining)
+                desc = {};
+        }
+
+        RelocationBlock desc{};
+    };
+
+    static_assert(std::forward_iterator<ImageView::RelocationIterator>);
+
+    [[nodiscard]] inline ImageView::RelocationIterator ImageView::relocationsBegin() const noexcept {
+        return ImageView::RelocationIterator{ *this };
+    }
+    [[nodiscard]] inline ImageView::RelocationIterator ImageView::relocationsEnd() const noexcept {
+        return {};
+    }
+
+#ifdef _WIN32
+    namespace detail {
         [[nodiscard]] void* getImportAddressTableEntry(const std::string& module, const std::string& fn, int ordinal = 0);
     } // namespace detail
 
-    // Returns the address of the import address table entry corresponding to the passed arguments.
-    // Returns nullptr if the entry doesn't exist or when it can't be found
+    // Returns the address of the import address table entry of the main module corresponding to the passed arguments,
+    // see ImportIndex. Returns nullptr if the entry doesn't exist or when it can't be found
     template <typename T>
     [[nodiscard]] T* getImportAddressTableEntry(const std::string& module, const std::string& fn, int ordinal = 0) {
         static_assert(std::is_pointer_v<T>);
 
         return reinterpret_cast<T*>(detail::getImportAddressTableEntry(module, fn, ordinal));
     }
+#endif
 
 } // namespace B3L
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "Define.h"
+#include "Hash.h"
+#include "ImageView.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace B3L {
+
+    // Import lookups of an image by module and name or ordinal. All imports are hashed into an open addressing table
+    // keyed by the lower case module name and the import name or ordinal in a single pass over the import directory on
+    // the first query. Module names compare case-insensitively like the loader does, import names are case-sensitive.
+    // Building is thread safe, the index has to outlive the imports it returns.
+    class ImportIndex {
+        B3L_MAKE_NONCOPYABLE(ImportIndex);
+
+    public:
+        explicit ImportIndex(const ImageView& image) noexcept : image(image) {
+        }
+
+        [[nodiscard]] static constexpr uint64_t moduleHash(std::string_view module) noexcept {
+            return Hash::fnv1aLower(module);
+        }
+
+        [[nodiscard]] static constexpr uint64_t nameHash(std::string_view name) noexcept {
+            return Hash::fnv1a(name);
+        }
+
+        [[nodiscard]] std::optional<ImageView::Import> find(std::string_view module, std::string_view name) const;
+        [[nodiscard]] std::optional<ImageView::Import> find(std::string_view module, int ordinal) const;
+
+        // Number of imports of the image.
+        [[nodiscard]] size_t size() const;
+
+    private:
+        struct Slot {
+            uint64_t key      = 0;
+            uint32_t position = empty; // Into imports
+        };
+
+        static constexpr uint32_t empty = UINT32_MAX;
+
+        [[nodiscard]] static uint64_t key(uint64_t moduleHash, uint64_t symbol) noexcept {
+            return Hash::fnv1aValue(symbol, moduleHash);
+        }
+
+        // Ordinals are kept apart from name hashes by the ordinal flag.
+        [[nodiscard]] static uint64_t ordinalSymbol(int ordinal) noexcept {
+            return PE::ordinalFlag64 | static_cast<uint16_t>(ordinal);
+        }
+
+        void build() const;
+
+        template <typename Matches>
+        [[nodiscard]] std::optional<ImageView::Import> probe(uint64_t slotKey, Matches&& matches) const;
+
+        ImageView image;
+
+        mutable std::once_flag built;
+        mutable std::vector<Slot> slots; // Capacity is a power of two
+        mutable std::vector<ImageView::Import> imports;
+    };
+
+} // namespace B3L
@@ -0,0 +1,40 @@
+#pragma once
+#include "Define.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace B3L {
+
+    // Read only memory mapping of a whole file.
+    class MappedFile {
+        B3L_MAKE_NONCOPYABLE(MappedFile);
+
+    public:
+        // Maps the file at path. Throws std::system_error on failure.
+        explicit MappedFile(const std::filesystem::path& path);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        [[nodiscard]] const uint8_t* data() const noexcept {
+            return mapping;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return length;
+        }
+
+        [[nodiscard]] std::span<const uint8_t> bytes() const noexcept {
+            return { mapping, length };
+        }
+
+    private:
+        void unmap() noexcept;
+
+        const uint8_t* mapping = nullptr;
+        size_t length          = 0;
+    };
+
+} // namespace B3L
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace B3L {
+
+    // Mapping of the current process that contains an address.
+    struct MemoryRegion {
+        uintptr_t base = 0;
+        size_t size    = 0;
+        bool committed = false; // Backed by accessible memory, not just reserved or PROT_NONE
+    };
+
+    // Describes the memory layout of the current process. Validation of mapped images goes through this interface so
+    // that images can be checked against another source, e.g. an image that was mapped into a buffer by hand.
+    class MemoryQuery {
+    public:
+        virtual ~MemoryQuery() = default;
+
+        // Returns the region that contains address or std::nullopt if address is not mapped.
+        [[nodiscard]] virtual std::optional<MemoryRegion> query(const void* address) const = 0;
+
+        // VirtualQuery on Windows, /proc/self/maps on Linux.
+        [[nodiscard]] static const MemoryQuery& native();
+    };
+
+    // Describes a single buffer as the only committed memory, e.g. an image that was mapped into a buffer by hand.
+    class BufferMemoryQuery final : public MemoryQuery {
+    public:
+        explicit BufferMemoryQuery(std::span<const uint8_t> buffer) noexcept : buffer(buffer) {
+        }
+
+        [[nodiscard]] std::optional<MemoryRegion> query(const void* address) const override {
+            const auto begin = reinterpret_cast<uintptr_t>(buffer.data());
+            const auto value = reinterpret_cast<uintptr_t>(address);
+            if(value < begin || value >= begin + buffer.size())
+                return std::nullopt;
+            return MemoryRegion{ begin, buffer.size(), true };
+        }
+
+    private:
+        std::span<const uint8_t> buffer;
+    };
+
+} // namespace B3L
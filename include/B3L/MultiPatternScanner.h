@@ -0,0 +1,70 @@
+#pragma once
+#include "AOBScanner.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+    // Resolves a set of AOBPatterns in a single sweep over the haystack.
+    // Every pattern is indexed by a two byte exact anchor in a bucketed hash table. The sweep probes the table once per
+    // haystack position and only verifies patterns whose anchor matches, so cost scales with haystack size rather than
+    // haystack size times pattern count.
+    class MultiPatternScanner {
+    public:
+        struct Match {
+            size_t patternId;
+            size_t offset;
+
+            [[nodiscard]] bool operator==(const Match&) const noexcept = default;
+        };
+
+        // Pattern ids correspond to the indices in patterns.
+        explicit MultiPatternScanner(std::vector<AOBPattern> patterns);
+
+        // Returns all matches of all patterns ordered by offset and pattern id.
+        [[nodiscard]] std::vector<Match> scan(std::span<const uint8_t> haystack) const;
+
+        // Resolves every pattern at its first match, see AOBPattern::resolve. baseAddress is the address of the
+        // haystack in the scanned address space, e.g. the RVA of a section. Results are indexed by pattern id and
+        // std::nullopt for patterns without a match. The sweep stops once every pattern is resolved.
+        [[nodiscard]] std::vector<std::optional<uint64_t>> resolve(std::span<const uint8_t> haystack, uint64_t baseAddress) const;
+
+        // Resolves addresses in the current process.
+        [[nodiscard]] std::vector<std::optional<uint64_t>> resolve(std::span<const uint8_t> haystack) const;
+
+        [[nodiscard]] size_t patternCount() const noexcept;
+        [[nodiscard]] const AOBPattern& pattern(size_t patternId) const;
+
+    private:
+        struct Entry {
+            uint32_t patternId;
+            uint32_t anchorOffset;
+        };
+
+        // Compressed bucket storage, entries of bucket k are in [entries[offsets[k]], entries[offsets[k + 1]]).
+        // offsets lives on the heap, the pair table alone takes 256 KiB.
+        template <size_t BucketCount>
+        struct Table {
+            std::vector<uint32_t> offsets = std::vector<uint32_t>(BucketCount + 1);
+            std::vector<Entry> entries;
+        };
+
+        void buildTables();
+
+        // Calls onMatch(patternId, offset) for every match in order of anchor position, which is offset order per
+        // pattern. Stops when onMatch returns false.
+        template <typename OnMatch>
+        void sweep(std::span<const uint8_t> haystack, OnMatch&& onMatch) const;
+
+        std::vector<AOBPattern> patterns;
+
+        Table<0x10000> pairTable;       // Patterns with two adjacent exact bytes, keyed by both bytes.
+        Table<0x100> byteTable;         // Remaining patterns keyed by every byte matching their primary anchor.
+        std::vector<uint32_t> wildcard; // Patterns without any masked bit. These match at every position.
+
+        std::vector<uint64_t> pairFilter; // One bit per pairTable bucket, set if the bucket is non-empty.
+    };
+
+} // namespace B3L
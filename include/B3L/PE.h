@@ -0,0 +1,267 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// Platform independent PE structure definitions. Layouts match the ones in winnt.h.
+namespace B3L::PE {
+
+    constexpr uint16_t dosSignature          = 0x5A4D;     // MZ
+    constexpr uint32_t ntSignature           = 0x00004550; // PE\0\0
+    constexpr uint16_t optionalHeader32Magic = 0x10B;
+    constexpr uint16_t optionalHeader64Magic = 0x20B;
+    constexpr int numberOfDirectoryEntries   = 16;
+    constexpr int sizeOfShortName            = 8;
+    constexpr uint32_t ordinalFlag32         = 0x80000000;
+    constexpr uint64_t ordinalFlag64         = 0x8000000000000000;
+
+    namespace DirectoryEntry {
+        constexpr int Export        = 0;
+        constexpr int Import        = 1;
+        constexpr int Resource      = 2;
+        constexpr int Exception     = 3;
+        constexpr int Security      = 4;
+        constexpr int BaseReloc     = 5;
+        constexpr int Debug         = 6;
+        constexpr int Architecture  = 7;
+        constexpr int GlobalPtr     = 8;
+        constexpr int Tls           = 9;
+        constexpr int LoadConfig    = 10;
+        constexpr int BoundImport   = 11;
+        constexpr int Iat           = 12;
+        constexpr int DelayImport   = 13;
+        constexpr int ComDescriptor = 14;
+    } // namespace DirectoryEntry
+
+    namespace SectionCharacteristics {
+        constexpr uint32_t CntCode              = 0x00000020;
+        constexpr uint32_t CntInitializedData   = 0x00000040;
+        constexpr uint32_t CntUninitializedData = 0x00000080;
+        constexpr uint32_t MemDiscardable       = 0x02000000;
+        constexpr uint32_t MemShared            = 0x10000000;
+        constexpr uint32_t MemExecute           = 0x20000000;
+        constexpr uint32_t MemRead              = 0x40000000;
+        constexpr uint32_t MemWrite             = 0x80000000;
+    } // namespace SectionCharacteristics
+
+    // Types of base relocation entries, stored in the upper 4 bits of each entry.
+    namespace RelocationType {
+        constexpr int Absolute = 0;  // Padding
+        constexpr int HighLow  = 3;  // 32 bit field
+        constexpr int Dir64    = 10; // 64 bit field
+    } // namespace RelocationType
+
+#pragma pack(push, 1)
+
+    struct DosHeader {
+        uint16_t e_magic;
+        uint16_t e_cblp;
+        uint16_t e_cp;
+        uint16_t e_crlc;
+        uint16_t e_cparhdr;
+        uint16_t e_minalloc;
+        uint16_t e_maxalloc;
+        uint16_t e_ss;
+        uint16_t e_sp;
+        uint16_t e_csum;
+        uint16_t e_ip;
+        uint16_t e_cs;
+        uint16_t e_lfarlc;
+        uint16_t e_ovno;
+        uint16_t e_res[4];
+        uint16_t e_oemid;
+        uint16_t e_oeminfo;
+        uint16_t e_res2[10];
+        int32_t e_lfanew;
+    };
+
+    struct FileHeader {
+        uint16_t Machine;
+        uint16_t NumberOfSections;
+        uint32_t TimeDateStamp;
+        uint32_t PointerToSymbolTable;
+        uint32_t NumberOfSymbols;
+        uint16_t SizeOfOptionalHeader;
+        uint16_t Characteristics;
+    };
+
+    struct DataDirectory {
+        uint32_t VirtualAddress;
+        uint32_t Size;
+    };
+
+    struct OptionalHeader32 {
+        uint16_t Magic;
+        uint8_t MajorLinkerVersion;
+        uint8_t MinorLinkerVersion;
+        uint32_t SizeOfCode;
+        uint32_t SizeOfInitializedData;
+        uint32_t SizeOfUninitializedData;
+        uint32_t AddressOfEntryPoint;
+        uint32_t BaseOfCode;
+        uint32_t BaseOfData;
+        uint32_t ImageBase;
+        uint32_t SectionAlignment;
+        uint32_t FileAlignment;
+        uint16_t MajorOperatingSystemVersion;
+        uint16_t MinorOperatingSystemVersion;
+        uint16_t MajorImageVersion;
+        uint16_t MinorImageVersion;
+        uint16_t MajorSubsystemVersion;
+        uint16_t MinorSubsystemVersion;
+        uint32_t Win32VersionValue;
+        uint32_t SizeOfImage;
+        uint32_t SizeOfHeaders;
+        uint32_t CheckSum;
+        uint16_t Subsystem;
+        uint16_t DllCharacteristics;
+        uint32_t SizeOfStackReserve;
+        uint32_t SizeOfStackCommit;
+        uint32_t SizeOfHeapReserve;
+        uint32_t SizeOfHeapCommit;
+        uint32_t LoaderFlags;
+        uint32_t NumberOfRvaAndSizes;
+        PE::DataDirectory DataDirectory[numberOfDirectoryEntries];
+    };
+
+    struct OptionalHeader64 {
+        uint16_t Magic;
+        uint8_t MajorLinkerVersion;
+        uint8_t MinorLinkerVersion;
+        uint32_t SizeOfCode;
+        uint32_t SizeOfInitializedData;
+        uint32_t SizeOfUninitializedData;
+        uint32_t AddressOfEntryPoint;
+        uint32_t BaseOfCode;
+        uint64_t ImageBase;
+        uint32_t SectionAlignment;
+        uint32_t FileAlignment;
+        uint16_t MajorOperatingSystemVersion;
+        uint16_t MinorOperatingSystemVersion;
+        uint16_t MajorImageVersion;
+        uint16_t MinorImageVersion;
+        uint16_t MajorSubsystemVersion;
+        uint16_t MinorSubsystemVersion;
+        uint32_t Win32VersionValue;
+        uint32_t SizeOfImage;
+        uint32_t SizeOfHeaders;
+        uint32_t CheckSum;
+        uint16_t Subsystem;
+        uint16_t DllCharacteristics;
+        uint64_t SizeOfStackReserve;
+        uint64_t SizeOfStackCommit;
+        uint64_t SizeOfHeapReserve;
+        uint64_t SizeOfHeapCommit;
+        uint32_t LoaderFlags;
+        uint32_t NumberOfRvaAndSizes;
+        PE::DataDirectory DataDirectory[numberOfDirectoryEntries];
+    };
+
+    struct SectionHeader {
+        uint8_t Name[sizeOfShortName];
+        union {
+            uint32_t PhysicalAddress;
+            uint32_t VirtualSize;
+        } Misc;
+        uint32_t VirtualAddress;
+        uint32_t SizeOfRawData;
+        uint32_t PointerToRawData;
+        uint32_t PointerToRelocations;
+        uint32_t PointerToLinenumbers;
+        uint16_t NumberOfRelocations;
+        uint16_t NumberOfLinenumbers;
+        uint32_t Characteristics;
+    };
+
+    struct NtHeaders32 {
+        uint32_t Signature;
+        PE::FileHeader FileHeader;
+        OptionalHeader32 OptionalHeader;
+    };
+
+    struct NtHeaders64 {
+        uint32_t Signature;
+        PE::FileHeader FileHeader;
+        OptionalHeader64 OptionalHeader;
+    };
+
+    struct ImportDescriptor {
+        union {
+            uint32_t Characteristics;
+            uint32_t OriginalFirstThunk; // RVA of the import lookup table
+        };
+        uint32_t TimeDateStamp;
+        uint32_t ForwarderChain;
+        uint32_t Name;
+        uint32_t FirstThunk; // RVA of the import address table
+    };
+
+    struct ThunkData32 {
+        union {
+            uint32_t ForwarderString;
+            uint32_t Function;
+            uint32_t Ordinal;
+            uint32_t AddressOfData;
+        } u1;
+    };
+
+    struct ThunkData64 {
+        union {
+            uint64_t ForwarderString;
+            uint64_t Function;
+            uint64_t Ordinal;
+            uint64_t AddressOfData;
+        } u1;
+    };
+
+    struct ImportByName {
+        uint16_t Hint;
+        char Name[1]; // Null terminated
+    };
+
+    struct ExportDirectory {
+        uint32_t Characteristics;
+        uint32_t TimeDateStamp;
+        uint16_t MajorVersion;
+        uint16_t MinorVersion;
+        uint32_t Name;
+        uint32_t Base; // Ordinal of the first function
+        uint32_t NumberOfFunctions;
+        uint32_t NumberOfNames;
+        uint32_t AddressOfFunctions;    // RVA of NumberOfFunctions function RVAs
+        uint32_t AddressOfNames;        // RVA of NumberOfNames name RVAs, sorted
+        uint32_t AddressOfNameOrdinals; // RVA of NumberOfNames 16 bit function indices
+    };
+
+    // Header of a block of base relocations, followed by 16 bit entries of type and page offset.
+    struct BaseRelocation {
+        uint32_t VirtualAddress;
+        uint32_t SizeOfBlock; // Including the header
+    };
+
+#pragma pack(pop)
+
+    static_assert(sizeof(DosHeader) == 64);
+    static_assert(sizeof(FileHeader) == 20);
+    static_assert(sizeof(DataDirectory) == 8);
+    static_assert(sizeof(OptionalHeader32) == 224);
+    static_assert(sizeof(OptionalHeader64) == 240);
+    static_assert(sizeof(SectionHeader) == 40);
+    static_assert(sizeof(NtHeaders32) == 248);
+    static_assert(sizeof(NtHeaders64) == 264);
+    static_assert(sizeof(ImportDescriptor) == 20);
+    static_assert(sizeof(ThunkData32) == 4);
+    static_assert(sizeof(ThunkData64) == 8);
+    static_assert(sizeof(ExportDirectory) == 40);
+    static_assert(sizeof(BaseRelocation) == 8);
+
+    // Layouts of images loaded into the current process.
+    constexpr bool native64Bit = sizeof(void*) == 8;
+
+    using NtHeaders      = std::conditional_t<native64Bit, NtHeaders64, NtHeaders32>;
+    using OptionalHeader = std::conditional_t<native64Bit, OptionalHeader64, OptionalHeader32>;
+    using ThunkData      = std::conditional_t<native64Bit, ThunkData64, ThunkData32>;
+
+    constexpr uint16_t optionalHeaderMagic = native64Bit ? optionalHeader64Magic : optionalHeader32Magic;
+    constexpr uint64_t ordinalFlag         = native64Bit ? ordinalFlag64 : ordinalFlag32;
+
+} // namespace B3L::PE
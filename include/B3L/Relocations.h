@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+namespace B3L {
+
+    // Applies the base relocations of an image that was mapped into writable memory by hand, e.g. for analysis, as if it
+    // was loaded at newBase. PE32 and PE32+ images are accepted regardless of the native layout. The delta is taken
+    // from ImageBase of the optional header, which is set to newBase afterwards. Pages are relocated on up to
+    // threadCount threads, a threadCount of 0 selects the hardware concurrency. Relocation types other than HIGHLOW and
+    // DIR64 and fields outside of the image are skipped. Returns false if the headers of image are invalid or newBase
+    // doesn't fit into the ImageBase of a PE32 image.
+    bool applyRelocations(std::span<uint8_t> image, uint64_t newBase, unsigned threadCount = 0);
+
+} // namespace B3L
@@ -0,0 +1,52 @@
+#pragma once
+#include "Define.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+#ifdef _WIN32
+    using ProcessId = uint32_t;
+#else
+    using ProcessId = int;
+#endif
+
+    // Reads memory of another process. Reads are batched, multiple ranges are transferred with a single system call
+    // where the platform supports it (process_vm_readv on Linux, ReadProcessMemory per range on Windows).
+    class RemoteMemorySource {
+        B3L_MAKE_NONCOPYABLE(RemoteMemorySource);
+
+    public:
+        struct Region {
+            uint64_t address = 0;
+            size_t size      = 0;
+        };
+
+        // Throws std::system_error if the process does not exist or can't be opened.
+        explicit RemoteMemorySource(ProcessId processId);
+        RemoteMemorySource(RemoteMemorySource&& other) noexcept;
+        RemoteMemorySource& operator=(RemoteMemorySource&& other) noexcept;
+        ~RemoteMemorySource();
+
+        // Returns the readable regions of the process in ascending address order.
+        [[nodiscard]] std::vector<Region> regions() const;
+
+        // Reads ranges into consecutive parts of buffer, which has to hold the sum of all range sizes. bytesRead[i]
+        // receives the number of bytes of ranges[i] that could be read, ranges may be partially unreadable.
+        // Returns the total number of bytes read.
+        size_t read(std::span<const Region> ranges, uint8_t* buffer, std::span<size_t> bytesRead) const;
+
+        [[nodiscard]] ProcessId processId() const noexcept {
+            return pid;
+        }
+
+    private:
+        ProcessId pid = 0;
+#ifdef _WIN32
+        void* process = nullptr;
+#endif
+    };
+
+} // namespace B3L
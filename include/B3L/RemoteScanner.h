@@ -0,0 +1,29 @@
+#pragma once
+#include "AOBScanner.h"
+#include "RemoteMemorySource.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+    // Scans the memory of another process. Regions are read in blocks of up to blockSize bytes, small regions are
+    // batched into a single read. The next block is read while the current one is scanned.
+    // Matches are returned as addresses in the remote process, in ascending order.
+    class RemoteScanner {
+    public:
+        static constexpr size_t defaultBlockSize = 1024 * 1024;
+
+        // Scans all readable regions of the process.
+        [[nodiscard]] static std::vector<uint64_t>
+        findAll(const RemoteMemorySource& source, const AOBPattern& needle, size_t blockSize = defaultBlockSize);
+
+        // Scans the given regions, which have to be sorted by address and must not overlap.
+        [[nodiscard]] static std::vector<uint64_t> findAll(const RemoteMemorySource& source,
+                                                           std::span<const RemoteMemorySource::Region> regions,
+                                                           const AOBPattern& needle,
+                                                           size_t blockSize = defaultBlockSize);
+    };
+
+} // namespace B3L
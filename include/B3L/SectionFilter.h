@@ -0,0 +1,36 @@
+#pragma once
+#include "PE.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace B3L {
+
+    // Selects the sections of an image that are scanned. A default constructed filter accepts every section.
+    struct SectionFilter {
+        // Section characteristics that all have to be set, e.g. PE::SectionCharacteristics::MemExecute.
+        uint32_t requiredCharacteristics = 0;
+        // Section characteristics of which none may be set.
+        uint32_t excludedCharacteristics = 0;
+        // Accepted section names, any name is accepted if empty.
+        std::vector<std::string> names;
+
+        [[nodiscard]] static SectionFilter executable();
+        [[nodiscard]] static SectionFilter named(std::string name);
+
+        [[nodiscard]] bool accepts(uint32_t characteristics, std::string_view name) const;
+
+        // Returns the indices of all accepted sections of image, works with ImageView and FileImageView.
+        template <typename Image>
+        [[nodiscard]] std::vector<int> select(const Image& image) const {
+            std::vector<int> indices;
+            for(int index = 0; index < image.sectionCount(); ++index) {
+                if(accepts(image.section(index)->Characteristics, image.sectionName(index)))
+                    indices.push_back(index);
+            }
+            return indices;
+        }
+    };
+
+} // namespace B3L
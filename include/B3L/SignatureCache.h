@@ -0,0 +1,53 @@
+#pragma once
+#include "AOBScanner.h"
+#include "ImageScanner.h"
+#include "ImageView.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <unordered_map>
+
+namespace B3L {
+
+    // Identifies an image build. Images with equal identity are assumed to have identical contents.
+    struct ImageIdentity {
+        uint32_t timestamp   = 0;
+        uint32_t sizeOfImage = 0;
+        uint64_t sectionHash = 0; // Hash of all section headers
+
+        [[nodiscard]] static ImageIdentity of(const ImageView& image);
+
+        [[nodiscard]] bool operator==(const ImageIdentity&) const noexcept = default;
+    };
+
+    // Persistent pattern to RVA resolution cache. Cached results are verified against the image in O(pattern size) and
+    // fall back to a scan if the image identity changed or the pattern no longer matches at the cached RVA.
+    // Each signature holds a single result, use one cache file per module.
+    class SignatureCache {
+    public:
+        // Loads the cache from path. A missing or malformed file results in an empty cache.
+        explicit SignatureCache(std::filesystem::path path);
+
+        // Returns the RVA of the first match of needle in the sections of image accepted by filter.
+        [[nodiscard]] std::optional<uint32_t>
+        resolve(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter = {});
+
+        // Writes the cache if it changed since it was loaded. The file is replaced atomically. Throws on IO failure.
+        void save();
+
+        [[nodiscard]] size_t size() const noexcept;
+
+    private:
+        struct Entry {
+            ImageIdentity identity;
+            uint32_t rva = 0;
+        };
+
+        void load();
+
+        std::filesystem::path path;
+        std::unordered_map<uint64_t, Entry> entries; // Keyed by pattern and section filter hash
+        bool dirty = false;
+    };
+
+} // namespace B3L
@@ -0,0 +1,93 @@
+#pragma once
+#include "AOBScanner.h"
+#include "MappedFile.h"
+#include "SectionFilter.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace B3L {
+
+    // Signature file parsed in bulk. Every line that is neither empty nor a '#' comment holds one signature, either as
+    // text fields separated by '|'
+    //   PlayerBase | 48 8B 05 <rel4> 48 85 C0 | .text | game.dll
+    // or as a JSON object with string members
+    //   {"name": "PlayerBase", "pattern": "48 8B 05 <rel4> 48 85 C0", "section": ".text", "module": "game.dll"}
+    // section and module are optional. Names, pattern strings and constraints are views into the source, the pattern
+    // bytes of all signatures share one arena. Loading doesn't allocate per signature.
+    class SignatureDatabase {
+    public:
+        struct Signature {
+            std::string_view name;
+            std::string_view source;  // Pattern string
+            std::string_view section; // Empty if any section is accepted
+            std::string_view module;  // Empty if any module is accepted
+            std::span<const uint8_t> value;
+            std::span<const uint8_t> mask;
+
+            [[nodiscard]] SectionFilter sectionFilter() const;
+        };
+
+        // Parses text, which has to outlive the database. Malformed lines are skipped and reported by errors().
+        explicit SignatureDatabase(std::string_view text);
+
+        // Maps and parses the file at path. Throws std::system_error if it can't be mapped.
+        [[nodiscard]] static SignatureDatabase open(const std::filesystem::path& path);
+
+        [[nodiscard]] size_t size() const noexcept {
+            return records.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return records.empty();
+        }
+
+        // Signatures are numbered in file order.
+        [[nodiscard]] Signature operator[](size_t index) const noexcept;
+
+        // Returns the index of the first signature named name.
+        [[nodiscard]] std::optional<size_t> find(std::string_view name) const noexcept;
+
+        // Creates the AOBPattern of a signature from its decoded bytes, including its captures. std::nullopt if capture
+        // names are duplicated.
+        [[nodiscard]] std::optional<AOBPattern> pattern(size_t index) const;
+
+        // 1-based numbers of the lines that were skipped because they are malformed.
+        [[nodiscard]] std::span<const size_t> errors() const noexcept {
+            return malformed;
+        }
+
+    private:
+        struct Record {
+            std::string_view name;
+            std::string_view source;
+            std::string_view section;
+            std::string_view module;
+            size_t offset; // Value bytes followed by mask bytes in arena
+            size_t size;
+            size_t firstCapture; // Index of the first capture marker in captures
+            size_t captureCount;
+        };
+
+        struct CaptureRecord {
+            detail::CaptureMarker marker; // Name is a view into the source
+            size_t offset;
+        };
+
+        explicit SignatureDatabase(MappedFile mappedFile);
+
+        void parse(std::string_view text);
+
+        std::optional<MappedFile> file; // Source of the views if opened from a file
+        std::vector<Record> records;
+        std::vector<uint8_t> arena;
+        std::vector<CaptureRecord> captures;
+        std::vector<uint32_t> byName; // Record indices sorted by name
+        std::vector<size_t> malformed;
+    };
+
+} // namespace B3L
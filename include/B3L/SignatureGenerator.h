@@ -0,0 +1,93 @@
+#pragma once
+#include "AOBScanner.h"
+#include "SectionFilter.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+    class ImageView;
+
+    // Generates the shortest patterns that match exactly once within a set of code regions, e.g. the executable
+    // sections of an image. Uniqueness is checked against a 4-gram index of the regions: the candidates of the first
+    // exact 4-byte run of a pattern are looked up once and narrowed down byte by byte as the pattern grows.
+    class SignatureGenerator {
+    public:
+        struct Region {
+            uint64_t address;
+            std::span<const uint8_t> data;
+        };
+
+        // Field that is rewritten when the image is relocated.
+        struct Relocation {
+            uint64_t address;
+            uint8_t size;
+        };
+
+        static constexpr size_t defaultMaxLength = 128;
+
+        // Indexes regions, which have to outlive the generator. relocations don't need to be sorted. is64Bit selects
+        // the instruction set used by generate().
+        SignatureGenerator(std::vector<Region> regions,
+                           std::vector<Relocation> relocations = {},
+                           bool is64Bit                        = sizeof(void*) == 8,
+                           size_t maxLength                    = defaultMaxLength);
+
+        // Indexes the sections of a mapped image accepted by filter and collects its base relocations.
+        [[nodiscard]] static SignatureGenerator fromImage(const ImageView& image,
+                                                          const SectionFilter& filter = SectionFilter::executable(),
+                                                          size_t maxLength            = defaultMaxLength);
+
+#ifdef B3L_HAVE_ASSEMBLERS
+        // Returns the shortest unique pattern for the code at address. Instructions are decoded to wildcard branch
+        // offsets, RIP relative displacements and relocated fields, which change between builds or load addresses.
+        [[nodiscard]] std::optional<AOBPattern> generate(uint64_t address) const;
+#endif
+
+        // Returns the shortest prefix of the pattern given by value and mask that matches within the regions only at
+        // address. Returns std::nullopt if address is outside of the regions, the pattern doesn't match there or no
+        // prefix of at most maxLength bytes is unique.
+        [[nodiscard]] std::optional<AOBPattern>
+        shortestUnique(uint64_t address, std::span<const uint8_t> value, std::span<const uint8_t> mask) const;
+
+        [[nodiscard]] bool is64Bit() const noexcept {
+            return _is64Bit;
+        }
+
+        [[nodiscard]] size_t maxLength() const noexcept {
+            return _maxLength;
+        }
+
+    private:
+        struct Location {
+            size_t region;
+            size_t offset;
+        };
+
+        // Global positions number the bytes of all regions consecutively.
+        [[nodiscard]] std::optional<Location> locateAddress(uint64_t address) const noexcept;
+        [[nodiscard]] Location locatePosition(size_t position) const noexcept;
+
+        // Locations at which the pattern prefix [0, length) matches. length is set to the end of the first exact 4-byte
+        // run, whose candidates are looked up in the index. Patterns without such a run are scanned for in full.
+        [[nodiscard]] std::vector<Location>
+        seedCandidates(std::span<const uint8_t> value, std::span<const uint8_t> mask, size_t& length) const;
+
+        void buildIndex();
+
+        std::vector<Region> regions;
+        std::vector<size_t> regionStarts;    // Global position of the first byte of each region
+        std::vector<Relocation> relocations; // Sorted by address
+        bool _is64Bit;
+        size_t _maxLength;
+
+        // 4-gram positions bucketed by hash, positions of bucket k are in [positions[offsets[k]], positions[offsets[k + 1]])
+        unsigned bucketBits = 0;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> positions;
+    };
+
+} // namespace B3L
@@ -0,0 +1,74 @@
+#pragma once
+#include "AOBScanner.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace B3L {
+
+    // Scans input that arrives in successive chunks, e.g. blocks read from a file or another process.
+    // Keeps the last needle.size() - 1 bytes of the input to find matches crossing chunk borders, memory use is
+    // independent of the total input size. Matches are reported as absolute offsets into the concatenated input.
+    class StreamingScanner {
+    public:
+        explicit StreamingScanner(AOBPattern needle);
+
+        // Scans the next chunk and invokes onMatch(uint64_t offset) for every match that ends within it, in ascending order.
+        template <typename Callback>
+        void feed(std::span<const uint8_t> chunk, Callback&& onMatch);
+
+        // Scans the next chunk and returns the offsets of all matches that end within it.
+        [[nodiscard]] std::vector<uint64_t> feed(std::span<const uint8_t> chunk);
+
+        // Forgets all previous input.
+        void reset() noexcept;
+
+        // Total number of bytes fed since construction or the last reset.
+        [[nodiscard]] uint64_t position() const noexcept;
+
+        [[nodiscard]] const AOBPattern& pattern() const noexcept;
+
+    private:
+        // Keeps the last needle.size() - 1 bytes of the input seen so far.
+        void updateCarry(std::span<const uint8_t> chunk);
+
+        AOBPattern needle;
+        uint64_t consumed = 0;
+
+        std::vector<uint8_t> carry;    // Tail of the previous input, at most needle.size() - 1 bytes
+        std::vector<uint8_t> boundary; // carry followed by the head of the current chunk
+    };
+
+    template <typename Callback>
+    inline void StreamingScanner::feed(std::span<const uint8_t> chunk, Callback&& onMatch) {
+        const auto size = needle.size();
+
+        // Matches starting in the carried over tail of the previous input
+        if(!carry.empty()) {
+            const auto head = (std::min)(chunk.size(), size - 1);
+
+            boundary.assign(carry.begin(), carry.end());
+            boundary.insert(boundary.end(), chunk.begin(), chunk.begin() + head);
+
+            const uint8_t* begin = boundary.data();
+            const uint8_t* end   = begin + boundary.size();
+            const auto base      = consumed - carry.size();
+
+            for(auto pos = begin; (pos = detail::findPattern(pos, end, needle)) != end; ++pos) {
+                if(static_cast<size_t>(pos - begin) >= carry.size())
+                    break;
+                onMatch(base + (pos - begin));
+            }
+        }
+
+        // Matches starting in the current chunk
+        const auto begin = chunk.data();
+        const auto end   = begin + chunk.size();
+        for(auto pos = begin; (pos = detail::findPattern(pos, end, needle)) != end; ++pos)
+            onMatch(consumed + (pos - begin));
+
+        updateCarry(chunk);
+        consumed += chunk.size();
+    }
+
+} // namespace B3L
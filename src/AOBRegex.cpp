@@ -0,0 +1,464 @@
+#include "AOBRegex.h"
+#include "AOBScanner.h"
+#include "Simd.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+using namespace B3L;
+
+namespace {
+
+    using ByteSet = std::array<bool, 256>;
+
+    // Glushkov sets of a sub pattern.
+    struct Fragment {
+        uint64_t first = 0;
+        uint64_t last  = 0;
+        bool nullable  = true;
+    };
+
+    // Recursive descent parser that builds the Glushkov automaton while parsing.
+    //   alternation := sequence ('|' sequence)*
+    //   sequence    := item*
+    //   item        := byte | '[' class ']' | '(' alternation ')' | '{' n [',' m] '}'
+    class Parser {
+    public:
+        explicit Parser(std::string_view str) : str(str) {
+        }
+
+        std::optional<Fragment> parse() {
+            auto fragment = alternation();
+            if(!fragment || peek() != '\0')
+                return std::nullopt;
+            return fragment;
+        }
+
+        std::array<uint64_t, 256> byteMasks{};
+        std::vector<uint64_t> follow;
+
+    private:
+        // Returns next non-whitespace character without consuming it or 0 at the end of the string
+        char peek() {
+            while(pos < str.size() && detail::isPatternWhitespace(str[pos]))
+                ++pos;
+            return pos < str.size() ? str[pos] : '\0';
+        }
+
+        char next() {
+            const auto c = peek();
+            if(c)
+                ++pos;
+            return c;
+        }
+
+        std::optional<Fragment> alternation() {
+            auto result = sequence();
+            while(result && peek() == '|') {
+                ++pos;
+                const auto branch = sequence();
+                if(!branch)
+                    return std::nullopt;
+
+                result->first |= branch->first;
+                result->last |= branch->last;
+                result->nullable |= branch->nullable;
+            }
+            return result;
+        }
+
+        std::optional<Fragment> sequence() {
+            Fragment result;
+            for(char c = peek(); c && c != '|' && c != ')'; c = peek()) {
+                const auto fragment = item();
+                if(!fragment)
+                    return std::nullopt;
+                result = concat(result, *fragment);
+            }
+            return result;
+        }
+
+        std::optional<Fragment> item() {
+            const auto c = peek();
+            if(c == '(') {
+                ++pos;
+                auto group = alternation();
+                if(!group || next() != ')')
+                    return std::nullopt;
+                return group;
+            }
+            if(c == '[') {
+                ++pos;
+                return byteClass();
+            }
+            if(c == '{') {
+                ++pos;
+                return gap();
+            }
+
+            const auto set = byte();
+            if(!set)
+                return std::nullopt;
+            return position(*set);
+        }
+
+        // Exact, wildcard or masked byte in AOBPattern syntax.
+        std::optional<ByteSet> byte() {
+            const char high = next();
+            const char low  = next();
+
+            const int highValue = detail::hexDigitValue(high);
+            const int lowValue  = detail::hexDigitValue(low);
+            if((highValue < 0 && high != '?') || (lowValue < 0 && low != '?'))
+                return std::nullopt;
+
+            uint8_t value = static_cast<uint8_t>((highValue < 0 ? 0 : highValue << 4) | (lowValue < 0 ? 0 : lowValue));
+            uint8_t mask  = static_cast<uint8_t>((highValue < 0 ? 0 : 0xF0) | (lowValue < 0 ? 0 : 0x0F));
+
+            if(peek() == '/') {
+                ++pos;
+                const int maskHigh = detail::hexDigitValue(next());
+                const int maskLow  = detail::hexDigitValue(next());
+                if(mask != 0xFF || maskHigh < 0 || maskLow < 0)
+                    return std::nullopt;
+
+                mask = static_cast<uint8_t>(maskHigh << 4 | maskLow);
+                value &= mask;
+            }
+
+            ByteSet set{};
+            for(int b = 0; b < 256; ++b)
+                set[b] = (b & mask) == value;
+            return set;
+        }
+
+        std::optional<Fragment> byteClass() {
+            const bool negated = peek() == '^';
+            if(negated)
+                ++pos;
+
+            ByteSet set{};
+            while(peek() != ']') {
+                const auto low = byte();
+                if(!low)
+                    return std::nullopt;
+
+                if(peek() != '-') {
+                    for(int b = 0; b < 256; ++b)
+                        set[b] |= (*low)[b];
+                    continue;
+                }
+
+                // Range bounds have to be exact bytes
+                ++pos;
+                const auto high = byte();
+                if(!high || std::count(low->begin(), low->end(), true) != 1 || std::count(high->begin(), high->end(), true) != 1)
+                    return std::nullopt;
+
+                const auto from = std::find(low->begin(), low->end(), true) - low->begin();
+                const auto to   = std::find(high->begin(), high->end(), true) - high->begin();
+                if(from > to)
+                    return std::nullopt;
+
+                std::fill(set.begin() + from, set.begin() + to + 1, true);
+            }
+            ++pos;
+
+            if(negated) {
+                for(auto& b : set)
+                    b = !b;
+            }
+            return position(set);
+        }
+
+        std::optional<Fragment> gap() {
+            const auto min = number();
+            if(!min)
+                return std::nullopt;
+
+            auto max = min;
+            if(peek() == ',') {
+                ++pos;
+                max = number();
+            }
+            if(!max || *max < *min || next() != '}' || *max > AOBRegex::maxPositions)
+                return std::nullopt;
+
+            ByteSet any;
+            any.fill(true);
+
+            Fragment result;
+            for(size_t i = 0; i < *min; ++i) {
+                const auto current = position(any);
+                if(!current)
+                    return std::nullopt;
+                result = concat(result, *current);
+            }
+
+            // Optional tail "(?? (?? ...)?)?" of max - min bytes, every tail byte may end the gap
+            Fragment tail;
+            uint64_t previous = 0;
+            for(size_t i = *min; i < *max; ++i) {
+                const auto current = position(any);
+                if(!current)
+                    return std::nullopt;
+
+                if(previous)
+                    follow[std::countr_zero(previous)] |= current->first;
+                else
+                    tail.first = current->first;
+                tail.last |= current->last;
+                previous = current->first;
+            }
+
+            return concat(result, tail);
+        }
+
+        std::optional<size_t> number() {
+            peek();
+            size_t value  = 0;
+            size_t digits = 0;
+            for(; pos < str.size() && str[pos] >= '0' && str[pos] <= '9' && digits < 4; ++pos, ++digits)
+                value = value * 10 + (str[pos] - '0');
+            return digits ? std::optional(value) : std::nullopt;
+        }
+
+        std::optional<Fragment> position(const ByteSet& set) {
+            const auto index = follow.size();
+            if(index >= AOBRegex::maxPositions)
+                return std::nullopt;
+
+            const auto bit = uint64_t{ 1 } << index;
+            for(int b = 0; b < 256; ++b) {
+                if(set[b])
+                    byteMasks[b] |= bit;
+            }
+            follow.push_back(0);
+            return Fragment{ bit, bit, false };
+        }
+
+        Fragment concat(const Fragment& a, const Fragment& b) {
+            for(auto positions = a.last; positions; positions &= positions - 1)
+                follow[std::countr_zero(positions)] |= b.first;
+
+            return { a.first | (a.nullable ? b.first : 0), b.last | (b.nullable ? a.last : 0), a.nullable && b.nullable };
+        }
+
+        std::string_view str;
+        size_t pos = 0;
+    };
+
+} // namespace
+
+std::optional<AOBRegex> AOBRegex::fromString(std::string_view str, size_t maxDfaStates) {
+    Parser parser(str);
+    const auto fragment = parser.parse();
+    if(!fragment || fragment->nullable)
+        return std::nullopt;
+
+    AOBRegex regex;
+    regex.byteMasks = parser.byteMasks;
+    regex.follow    = std::move(parser.follow);
+    regex.first     = fragment->first;
+    regex.last      = fragment->last;
+
+    const auto count = regex.follow.size();
+    regex.precede.assign(count, 0);
+    for(size_t i = 0; i < count; ++i) {
+        for(auto positions = regex.follow[i]; positions; positions &= positions - 1)
+            regex.precede[std::countr_zero(positions)] |= uint64_t{ 1 } << i;
+    }
+
+    regex.followTables.resize((count + 7) / 8);
+    for(size_t k = 0; k < regex.followTables.size(); ++k) {
+        for(int b = 0; b < 256; ++b) {
+            uint64_t positions = 0;
+            for(int bit = 0; bit < 8 && k * 8 + bit < count; ++bit) {
+                if(b & (1 << bit))
+                    positions |= regex.follow[k * 8 + bit];
+            }
+            regex.followTables[k][b] = positions;
+        }
+    }
+
+    for(int b = 0; b < 256; ++b) {
+        if(regex.byteMasks[b] & regex.first)
+            regex.startBytes.push_back(static_cast<uint8_t>(b));
+    }
+    if(regex.startBytes.size() > 4)
+        regex.startBytes.clear();
+
+    if(!regex.buildDfa(maxDfaStates))
+        regex.transitions.clear();
+
+    return regex;
+}
+
+uint64_t AOBRegex::followOf(uint64_t positions) const noexcept {
+    uint64_t result = 0;
+    for(size_t k = 0; k < followTables.size() && positions; ++k, positions >>= 8)
+        result |= followTables[k][positions & 0xFF];
+    return result;
+}
+
+bool AOBRegex::buildDfa(size_t maxStates) {
+    if(maxStates == 0)
+        return false;
+    maxStates = (std::min)(maxStates, maxDfaStateLimit);
+
+    // Subset construction, every DFA state is the set of positions matched by the last byte
+    std::vector<uint64_t> states{ 0 };
+    std::unordered_map<uint64_t, uint32_t> ids{ { 0, 0 } };
+    std::vector<uint32_t> table;
+
+    for(size_t i = 0; i < states.size(); ++i) {
+        const auto reachable = followOf(states[i]) | first;
+        for(int b = 0; b < 256; ++b) {
+            const auto next        = reachable & byteMasks[b];
+            const auto [it, added] = ids.try_emplace(next, static_cast<uint32_t>(states.size()));
+            if(added) {
+                if(states.size() >= maxStates)
+                    return false;
+                states.push_back(next);
+            }
+            table.push_back(it->second);
+        }
+    }
+
+    // Renumber accepting states to the end so a single compare detects matches
+    std::vector<uint32_t> renumbered(states.size());
+    uint32_t nextId = 0;
+    for(size_t i = 0; i < states.size(); ++i) {
+        if(!(states[i] & last))
+            renumbered[i] = nextId++;
+    }
+    firstAccepting = nextId;
+    for(size_t i = 0; i < states.size(); ++i) {
+        if(states[i] & last)
+            renumbered[i] = nextId++;
+    }
+
+    transitions.resize(table.size());
+    for(size_t i = 0; i < states.size(); ++i) {
+        for(int b = 0; b < 256; ++b)
+            transitions[renumbered[i] * 256 + b] = static_cast<uint16_t>(renumbered[table[i * 256 + b]]);
+    }
+    return true;
+}
+
+const uint8_t* AOBRegex::skipToStart(const uint8_t* pos, const uint8_t* end) const noexcept {
+    if(startBytes.size() == 1) {
+        auto hit = static_cast<const uint8_t*>(std::memchr(pos, startBytes[0], end - pos));
+        return hit ? hit : end;
+    }
+
+#ifdef B3L_HAVE_SSE2
+    __m128i values[4];
+    for(size_t i = 0; i < 4; ++i)
+        values[i] = _mm_set1_epi8(static_cast<char>(startBytes[i % startBytes.size()]));
+
+    for(; end - pos >= 16; pos += 16) {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const auto eq    = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, values[0]), _mm_cmpeq_epi8(block, values[1])),
+                                        _mm_or_si128(_mm_cmpeq_epi8(block, values[2]), _mm_cmpeq_epi8(block, values[3])));
+        if(const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(eq)))
+            return pos + std::countr_zero(mask);
+    }
+#endif
+
+    for(; pos < end; ++pos) {
+        if(byteMasks[*pos] & first)
+            return pos;
+    }
+    return end;
+}
+
+const uint8_t* AOBRegex::findEnd(const uint8_t* pos, const uint8_t* end, ScanState& scanState) const noexcept {
+    const bool skip = !startBytes.empty();
+
+    if(!transitions.empty()) {
+        auto state = scanState.state;
+        while(pos < end) {
+            if(state == 0 && skip) {
+                pos = skipToStart(pos, end);
+                if(pos == end)
+                    break;
+            }
+
+            state = transitions[state * 256 + *pos++];
+            if(state >= firstAccepting) {
+                scanState.state = state;
+                return pos;
+            }
+        }
+        scanState.state = state;
+        return nullptr;
+    }
+
+    auto active = scanState.active;
+    while(pos < end) {
+        if(active == 0 && skip) {
+            pos = skipToStart(pos, end);
+            if(pos == end)
+                break;
+        }
+
+        active = (followOf(active) | first) & byteMasks[*pos++];
+        if(active & last) {
+            scanState.active = active;
+            return pos;
+        }
+    }
+    scanState.active = active;
+    return nullptr;
+}
+
+const uint8_t* AOBRegex::findBegin(const uint8_t* begin, const uint8_t* matchEnd) const noexcept {
+    // Positions from which the bytes up to matchEnd can be matched to the end of the pattern
+    auto pos       = matchEnd - 1;
+    auto positions = last & byteMasks[*pos];
+    auto result    = matchEnd;
+
+    // The automaton is acyclic, so this terminates after at most positionCount() bytes
+    while(positions) {
+        if(positions & first)
+            result = pos;
+        if(pos == begin)
+            break;
+
+        uint64_t preceding = 0;
+        for(; positions; positions &= positions - 1)
+            preceding |= precede[std::countr_zero(positions)];
+
+        positions = preceding & byteMasks[*--pos];
+    }
+    return result;
+}
+
+std::optional<AOBRegex::Match> AOBRegex::find(std::span<const uint8_t> haystack) const noexcept {
+    const auto begin = haystack.data();
+    const auto end   = begin + haystack.size();
+
+    ScanState state;
+    const auto matchEnd = findEnd(begin, end, state);
+    if(!matchEnd)
+        return std::nullopt;
+
+    return Match{ findBegin(begin, matchEnd), matchEnd };
+}
+
+std::vector<AOBRegex::Match> AOBRegex::findAll(std::span<const uint8_t> haystack) const {
+    const auto begin = haystack.data();
+    const auto end   = begin + haystack.size();
+
+    std::vector<Match> matches;
+
+    ScanState state;
+    auto pos = begin;
+    while(auto matchEnd = findEnd(pos, end, state)) {
+        matches.push_back({ findBegin(begin, matchEnd), matchEnd });
+        pos = matchEnd;
+    }
+    return matches;
+}
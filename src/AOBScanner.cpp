@@ -1,6 +1,10 @@
 #include "AOBScanner.h"
+#include "Hash.h"
+#include "Parallel.h"
+#include "ScanKernels.h"
 #include "StringUtil.h"
 #include <algorithm>
+#include <atomic>
 #include <charconv>
 #include <optional>
 #include <string>
@@ -25,60 +29,283 @@ namespace {
         return true;
     }
 
+    constexpr size_t defaultChunkSize = 256 * 1024;
+
+    struct ChunkLayout {
+        size_t startCount;
+        size_t chunkSize;
+        size_t chunkCount;
+
+        // Candidate start positions of chunk index, the scanned range extends needle size - 1 bytes past its end.
+        [[nodiscard]] std::pair<size_t, size_t> startRange(size_t index) const noexcept {
+            const auto first = index * chunkSize;
+            return { first, (std::min)(first + chunkSize, startCount) };
+        }
+    };
+
+    ChunkLayout layoutChunks(size_t haystackSize, size_t needleSize, size_t chunkSize) {
+        const auto startCount = haystackSize - needleSize + 1;
+        if(!chunkSize)
+            chunkSize = defaultChunkSize;
+
+        return { startCount, chunkSize, (startCount + chunkSize - 1) / chunkSize };
+    }
+
 } // namespace
 
-bool AOBPattern::isValidPatternString(const std::string& str) {
-    if(str.empty())
-        return false;
+const uint8_t*
+B3L::detail::findPattern(const uint8_t* begin, const uint8_t* end, const AOBPattern& needle, ScanStrategy strategy) noexcept {
+    return scan(begin, end, makeScanPlan(needle), strategy);
+}
+
+const uint8_t* AOBScanner::findParallel(std::span<const uint8_t> haystack,
+                                        const AOBPattern& needle,
+                                        unsigned threadCount,
+                                        size_t chunkSize) {
+    const auto begin = haystack.data();
+    const auto end   = begin + haystack.size();
+    if(haystack.size() < needle.size() || needle.size() == 0)
+        return detail::findPattern(begin, end, needle);
+
+    const auto layout = layoutChunks(haystack.size(), needle.size(), chunkSize);
+
+    std::atomic<size_t> firstMatch = haystack.size();
+
+    detail::parallelFor(layout.chunkCount, threadCount, [&](size_t index) {
+        const auto [first, last] = layout.startRange(index);
+
+        // A match in an earlier chunk has already been found
+        if(first >= firstMatch.load(std::memory_order_relaxed))
+            return;
+
+        const auto chunkEnd = begin + last + needle.size() - 1;
+        const auto match    = detail::findPattern(begin + first, chunkEnd, needle);
+        if(match == chunkEnd)
+            return;
+
+        auto offset  = static_cast<size_t>(match - begin);
+        auto current = firstMatch.load(std::memory_order_relaxed);
+        while(offset < current && !firstMatch.compare_exchange_weak(current, offset, std::memory_order_relaxed)) {
+        }
+    });
+
+    return begin + firstMatch.load();
+}
+
+std::vector<const uint8_t*> AOBScanner::findAllParallel(std::span<const uint8_t> haystack,
+                                                        const AOBPattern& needle,
+                                                        unsigned threadCount,
+                                                        size_t chunkSize) {
+    if(haystack.size() < needle.size() || needle.size() == 0)
+        return {};
+
+    const auto begin  = haystack.data();
+    const auto layout = layoutChunks(haystack.size(), needle.size(), chunkSize);
 
-    if(str.size() % 2 != 0)
-        return false;
+    std::vector<std::vector<const uint8_t*>> chunkMatches(layout.chunkCount);
 
-    for(size_t pos = 0; pos < str.size(); ++pos) {
-        const char c = str[pos];
-        if((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
-            continue;
+    detail::parallelFor(layout.chunkCount, threadCount, [&](size_t index) {
+        const auto [first, last] = layout.startRange(index);
 
-        if(c == '?') { // Wild cards have to be of the form "??" with even alignment
-            if(pos % 2 != 0 || str[pos + 1] != '?')
-                return false;
+        const auto chunkEnd = begin + last + needle.size() - 1;
+        auto head           = begin + first;
+        while((head = detail::findPattern(head, chunkEnd, needle)) != chunkEnd) {
+            chunkMatches[index].push_back(head);
+            ++head;
+        }
+    });
+
+    // Chunks partition the start positions, concatenating them in chunk order yields address order
+    std::vector<const uint8_t*> matches;
+    for(const auto& chunk : chunkMatches)
+        matches.insert(matches.end(), chunk.begin(), chunk.end());
+
+    return matches;
+}
+
+std::vector<ApproximateMatch>
+AOBScanner::findApproximate(std::span<const uint8_t> haystack, const AOBPattern& needle, size_t maxMismatches) {
+    std::vector<ApproximateMatch> matches;
+
+    const auto size = needle.size();
+    if(haystack.size() < size)
+        return matches;
+
+    const auto begin = haystack.data();
+    const auto end   = begin + haystack.size();
+    const auto plan  = detail::makeScanPlan(needle);
+    const auto value = needle.value();
+    const auto mask  = needle.mask();
+
+    std::vector<size_t> masked;
+    for(size_t i = 0; i < size; ++i) {
+        if(mask[i])
+            masked.push_back(i);
+    }
+
+    // Pieces of a single byte hit too often to pay off over comparing every position
+    const auto pieceCount = maxMismatches + 1;
+    if(masked.size() / pieceCount < 2) {
+        detail::findApproximate(begin, end, plan, maxMismatches, matches);
+    } else {
+        std::vector<const uint8_t*> candidates;
+        for(size_t piece = 0; piece < pieceCount; ++piece) {
+            const auto first = masked[piece * masked.size() / pieceCount];
+            const auto last  = masked[(piece + 1) * masked.size() / pieceCount - 1];
 
-            ++pos;
-            continue;
+            const auto length  = last - first + 1;
+            const auto pattern = AOBPattern::fromBytes(value.subspan(first, length), mask.subspan(first, length)).value();
+
+            // Only hits that leave room for the whole needle around them
+            const auto pieceBegin = begin + first;
+            const auto pieceEnd   = end - (size - last - 1);
+            for(auto hit = pieceBegin; (hit = detail::findPattern(hit, pieceEnd, pattern)) != pieceEnd; ++hit)
+                candidates.push_back(hit - first);
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for(auto candidate : candidates) {
+            const auto mismatches = detail::countMismatches(candidate, plan, maxMismatches);
+            if(mismatches <= maxMismatches)
+                matches.push_back({ candidate, mismatches });
         }
-        return false;
     }
-    return true;
+
+    // Both paths produce address order
+    std::stable_sort(matches.begin(), matches.end(), [](const ApproximateMatch& a, const ApproximateMatch& b) {
+        return a.mismatches < b.mismatches;
+    });
+    return matches;
 }
 
 std::optional<AOBPattern> AOBPattern::fromString(const std::string& str) {
-    auto patternString = str;
+    const auto size = detail::parsePattern(str);
+    if(!size)
+        return std::nullopt;
 
-    StringUtil::removeWhitespace(patternString);
+    AOBPattern pattern;
+    pattern._value.resize(*size);
+    pattern._mask.resize(*size);
 
-    if(!isValidPatternString(patternString))
+    auto onCapture = [&](const detail::CaptureMarker& marker, size_t offset) {
+        pattern._captures.push_back({ std::string(marker.name), marker.kind, offset, marker.size, marker.trailing });
+    };
+    detail::parsePattern(str, pattern._value.data(), pattern._mask.data(), onCapture);
+
+    if(!pattern.uniqueCaptureNames())
+        return std::nullopt;
+
+    pattern.selectAnchors();
+    return pattern;
+}
+
+std::optional<AOBPattern> AOBPattern::fromBytes(std::span<const uint8_t> value, std::span<const uint8_t> mask) {
+    if(value.empty() || value.size() != mask.size())
         return std::nullopt;
 
     AOBPattern pattern;
-    pattern._bytes.resize(patternString.size() / 2);
+    pattern._value.assign(value.begin(), value.end());
+    pattern._mask.assign(mask.begin(), mask.end());
+
+    for(size_t i = 0; i < pattern._value.size(); ++i)
+        pattern._value[i] &= pattern._mask[i];
 
-    for(size_t pos = 0; pos < patternString.size(); pos += 2) {
-        auto it = patternString.data() + pos;
+    pattern.selectAnchors();
+    return pattern;
+}
 
-        if(*it == '?')
-            pattern._bytes[pos / 2] = -1;
-        else
-            std::from_chars(it, it + 2, pattern._bytes[pos / 2], 16);
+std::optional<AOBPattern>
+AOBPattern::fromBytes(std::span<const uint8_t> value, std::span<const uint8_t> mask, std::vector<Capture> captures) {
+    auto pattern = fromBytes(value, mask);
+    if(!pattern)
+        return std::nullopt;
+
+    for(const auto& capture : captures) {
+        if(capture.offset > value.size() || value.size() - capture.offset < capture.size)
+            return std::nullopt;
     }
+
+    pattern->_captures = std::move(captures);
+    if(!pattern->uniqueCaptureNames())
+        return std::nullopt;
     return pattern;
 }
 
-std::vector<int16_t>::const_iterator AOBPattern::begin() const noexcept {
-    return _bytes.begin();
+bool AOBPattern::uniqueCaptureNames() const noexcept {
+    for(size_t i = 0; i < _captures.size(); ++i) {
+        const auto& name = _captures[i].name;
+        if(!name.empty() && capture(name) != &_captures[i])
+            return false;
+    }
+    return true;
+}
+
+void AOBPattern::selectAnchors() noexcept {
+    const auto anchors = detail::selectAnchors(_value.data(), _mask.data(), _value.size(), ByteFrequencyTable::x86_64());
+    _primaryAnchor     = anchors.primary;
+    _secondaryAnchor   = anchors.secondary;
+}
+
+std::span<const uint8_t> AOBPattern::value() const noexcept {
+    return _value;
+}
+
+std::span<const uint8_t> AOBPattern::mask() const noexcept {
+    return _mask;
 }
 
-std::vector<int16_t>::const_iterator AOBPattern::end() const noexcept {
-    return _bytes.end();
+size_t AOBPattern::size() const noexcept {
+    return _value.size();
+}
+
+uint64_t AOBPattern::hash() const noexcept {
+    return Hash::fnv1a(_mask, Hash::fnv1a(_value));
+}
+
+bool AOBPattern::matchesAt(const uint8_t* data) const noexcept {
+    return detail::matchesAt(data, _value.data(), _mask.data(), _value.size());
+}
+
+int AOBPattern::primaryAnchor() const noexcept {
+    return _primaryAnchor;
+}
+
+int AOBPattern::secondaryAnchor() const noexcept {
+    return _secondaryAnchor;
+}
+
+std::span<const AOBPattern::Capture> AOBPattern::captures() const noexcept {
+    return _captures;
+}
+
+const AOBPattern::Capture* AOBPattern::capture(std::string_view name) const noexcept {
+    auto it = std::find_if(_captures.begin(), _captures.end(), [&](const Capture& capture) {
+        return capture.name == name;
+    });
+    return it != _captures.end() ? &*it : nullptr;
+}
+
+uint64_t AOBPattern::resolve(const uint8_t* match, uint64_t matchAddress) const noexcept {
+    return _captures.empty() ? matchAddress : _captures.front().resolve(match, matchAddress);
+}
+
+uint64_t AOBPattern::Capture::resolve(const uint8_t* match, uint64_t matchAddress) const noexcept {
+    // Fields are little endian
+    uint64_t field = 0;
+    for(size_t i = 0; i < size; ++i)
+        field |= static_cast<uint64_t>(match[offset + i]) << (i * 8);
+
+    if(kind == CaptureKind::Absolute)
+        return field;
+
+    const auto shift = 64 - size * 8;
+    const auto value = static_cast<uint64_t>(static_cast<int64_t>(field << shift) >> shift);
+    if(kind == CaptureKind::Raw)
+        return value;
+
+    return matchAddress + offset + size + trailing + value;
 }
 
 std::optional<std::vector<uint8_t>> B3L::parseByteArrayString(const std::string& str) {
@@ -0,0 +1,63 @@
+#include "ByteFrequencyTable.h"
+
+using namespace B3L;
+
+namespace {
+
+    // Occurrences per million bytes in the code sections of GCC compiled x86-64 binaries. MSVC pads functions with
+    // int3 instead of multi byte nops, the weight of 0xCC is raised to account for that.
+    constexpr std::array<uint64_t, 256> x86_64Counts = {
+            116525, 21654, 7741, 3936, 7999, 4517, 2160, 2363, 12674, 1370, 1131, 1044, 1817, 1793, 1041, 34828, // 00
+            8803, 2399, 992, 886, 1631, 1482, 844, 777, 4989, 1011, 722, 666, 922, 910, 800, 7935, // 10
+            5253, 921, 566, 678, 25344, 1275, 497, 501, 3136, 2685, 624, 1212, 969, 938, 1682, 591, // 20
+            3347, 6265, 506, 631, 1091, 1616, 624, 574, 2623, 5791, 750, 1524, 2699, 3001, 685, 1037, // 30
+            7076, 13751, 1285, 2795, 12400, 4962, 1296, 1843, 69875, 9276, 835, 903, 16300, 3971, 707, 803, // 40
+            3496, 712, 783, 2403, 3583, 3052, 1339, 1284, 2028, 625, 595, 2817, 2863, 3437, 1388, 1190, // 50
+            2031, 448, 481, 1091, 1157, 659, 8952, 591, 2050, 1638, 952, 833, 1622, 787, 1200, 1628, // 60
+            3181, 603, 917, 1346, 8589, 5055, 1352, 1058, 1882, 680, 675, 1469, 3248, 1677, 971, 2061, // 70
+            5025, 2074, 850, 13842, 16484, 16137, 1002, 1166, 2020, 39665, 478, 33057, 961, 9822, 700, 784, // 80
+            2872, 510, 618, 621, 1250, 932, 515, 473, 970, 1149, 435, 503, 762, 576, 470, 487, // 90
+            2402, 483, 465, 589, 653, 528, 507, 459, 1050, 584, 694, 564, 888, 520, 477, 841, // A0
+            1215, 473, 484, 535, 1019, 786, 2422, 3102, 2966, 1682, 3006, 905, 1766, 1432, 4087, 3669, // B0
+            10393, 3254, 2224, 5007, 2873, 2403, 4059, 6269, 1705, 1927, 2115, 772, 20000, 1116, 1010, 903, // C0
+            2605, 1127, 2714, 1339, 956, 911, 1261, 874, 1631, 728, 989, 1346, 645, 782, 1385, 2988, // D0
+            2500, 987, 1537, 767, 1294, 893, 1664, 2084, 20567, 8959, 1591, 2545, 2088, 1910, 1950, 3183, // E0
+            2233, 1079, 1376, 1965, 1023, 1279, 4219, 2356, 3699, 1863, 2581, 2526, 2486, 3396, 5671, 61472, // F0
+    };
+
+} // namespace
+
+ByteFrequencyTable::ByteFrequencyTable(const std::array<uint64_t, 256>& counts) noexcept : counts(counts) {
+    for(auto count : counts)
+        total += count;
+}
+
+const ByteFrequencyTable& ByteFrequencyTable::x86_64() noexcept {
+    static const ByteFrequencyTable table(x86_64Counts);
+    return table;
+}
+
+ByteFrequencyTable ByteFrequencyTable::fromSample(std::span<const uint8_t> sample) noexcept {
+    ByteFrequencyTable table;
+    table.add(sample);
+    return table;
+}
+
+void ByteFrequencyTable::add(std::span<const uint8_t> data) noexcept {
+    for(auto b : data)
+        ++counts[b];
+    total += data.size();
+}
+
+double ByteFrequencyTable::matchProbability(uint8_t value, uint8_t mask) const noexcept {
+    // Add-one smoothing
+    if(mask == 0xFF)
+        return static_cast<double>(counts[value] + 1) / static_cast<double>(total + 256);
+
+    uint64_t matching = 0;
+    for(int b = 0; b < 256; ++b) {
+        if((b & mask) == value)
+            matching += counts[b] + 1;
+    }
+    return static_cast<double>(matching) / static_cast<double>(total + 256);
+}
@@ -0,0 +1,82 @@
+#include "CompiledPattern.h"
+#include "ScanKernels.h"
+#include "Simd.h"
+
+using namespace B3L;
+
+namespace {
+
+    // Rough cost estimates in cycles, only their ratios matter. horspoolCost is calibrated against the strategy
+    // benchmark, in cache the interleaved Horspool scan breaks even with the AVX2 anchor compare at shifts of ~53.
+    constexpr double anchorBlockCost = 3.0;  // Two masked compares of one SIMD block
+    constexpr double verifyCost      = 15.0; // Full compare of a candidate
+    constexpr double horspoolCost    = 5.0;  // Lookup of the tail byte and shift of one window
+
+    double anchorCostPerByte(const CompiledPattern& pattern, const ByteFrequencyTable& frequencies) {
+        const auto& needle = pattern.pattern();
+        const auto a0      = pattern.primaryAnchor();
+        const auto a1      = pattern.secondaryAnchor();
+
+        auto candidateProbability = frequencies.matchProbability(needle.value()[a0], needle.mask()[a0]);
+        if(a1 != a0)
+            candidateProbability *= frequencies.matchProbability(needle.value()[a1], needle.mask()[a1]);
+
+        const auto blockSize = detail::cpuSupportsAvx2() ? 32.0 : 16.0;
+        return anchorBlockCost / blockSize + candidateProbability * verifyCost;
+    }
+
+    double horspoolCostPerByte(const std::array<uint32_t, 256>& skip, const ByteFrequencyTable& frequencies) {
+        double expectedShift = 0.0;
+        for(int b = 0; b < 256; ++b)
+            expectedShift += frequencies.matchProbability(static_cast<uint8_t>(b)) * skip[b];
+        return horspoolCost / expectedShift;
+    }
+
+} // namespace
+
+CompiledPattern CompiledPattern::compile(AOBPattern pattern, const ByteFrequencyTable& frequencies, ScanStrategy strategy) {
+    CompiledPattern compiled(std::move(pattern));
+
+    const auto& needle = compiled.needle;
+    const auto value   = needle.value().data();
+    const auto mask    = needle.mask().data();
+    const auto size    = needle.size();
+
+    const auto anchors        = detail::selectAnchors(value, mask, size, frequencies);
+    compiled._primaryAnchor   = anchors.primary;
+    compiled._secondaryAnchor = anchors.secondary;
+
+    compiled._matchProbability = 1.0;
+    for(size_t i = 0; i < size; ++i)
+        compiled._matchProbability *= frequencies.matchProbability(value[i], mask[i]);
+
+    compiled._strategy = ScanStrategy::Anchor;
+    if(anchors.primary < 0 || strategy == ScanStrategy::Anchor || mask[size - 1] != 0xFF)
+        return compiled;
+
+    detail::ScanPlan plan{ value, mask, size, anchors.primary, anchors.secondary };
+    detail::buildSkipTable(plan, compiled.skip);
+
+    if(strategy == ScanStrategy::Horspool ||
+       horspoolCostPerByte(compiled.skip, frequencies) < anchorCostPerByte(compiled, frequencies))
+        compiled._strategy = ScanStrategy::Horspool;
+
+    return compiled;
+}
+
+const uint8_t* CompiledPattern::find(const uint8_t* begin, const uint8_t* end) const noexcept {
+    const detail::ScanPlan plan{
+        needle.value().data(), needle.mask().data(), needle.size(), _primaryAnchor, _secondaryAnchor, skip.data()
+    };
+    return detail::scan(begin, end, plan, _strategy);
+}
+
+std::vector<const uint8_t*> CompiledPattern::findAll(std::span<const uint8_t> haystack) const {
+    std::vector<const uint8_t*> matches;
+
+    const auto end = haystack.data() + haystack.size();
+    for(auto pos = haystack.data(); (pos = find(pos, end)) != end; ++pos)
+        matches.push_back(pos);
+
+    return matches;
+}
@@ -0,0 +1,83 @@
+#include "ExportIndex.h"
+#include <algorithm>
+#include <bit>
+
+using namespace B3L;
+
+void ExportIndex::build() const {
+    if(!directory)
+        return;
+
+    const auto names    = image.RVAtoVA<const uint32_t*>(directory->AddressOfNames);
+    const auto ordinals = image.RVAtoVA<const uint16_t*>(directory->AddressOfNameOrdinals);
+
+    // At most half full, which keeps probe sequences short
+    slots.resize(std::bit_ceil(std::max<size_t>(2 * directory->NumberOfNames, 8)));
+    functionNames.assign(directory->NumberOfFunctions, ImageView::Export::noName);
+
+    const auto mask = slots.size() - 1;
+    for(uint32_t nameIndex = 0; nameIndex < directory->NumberOfNames; ++nameIndex) {
+        const auto nameHash = hash(image.RVAtoVA<const char*>(names[nameIndex]));
+
+        auto slot = nameHash & mask;
+        while(slots[slot].nameIndex != ImageView::Export::noName)
+            slot = (slot + 1) & mask;
+        slots[slot] = { nameHash, nameIndex };
+
+        // Names are sorted, the first name of a function wins
+        const auto functionIndex = ordinals[nameIndex];
+        if(functionIndex < functionNames.size() && functionNames[functionIndex] == ImageView::Export::noName)
+            functionNames[functionIndex] = nameIndex;
+    }
+}
+
+template <typename Matches>
+std::optional<ImageView::Export> ExportIndex::probe(uint64_t nameHash, Matches&& matches) const {
+    std::call_once(built, &ExportIndex::build, this);
+    if(slots.empty())
+        return std::nullopt;
+
+    const auto ordinals = image.RVAtoVA<const uint16_t*>(directory->AddressOfNameOrdinals);
+    const auto mask     = slots.size() - 1;
+    for(auto slot = nameHash & mask; slots[slot].nameIndex != ImageView::Export::noName; slot = (slot + 1) & mask) {
+        const auto& entry = slots[slot];
+        if(entry.hash == nameHash && matches(entry.nameIndex))
+            return makeExport(ordinals[entry.nameIndex], entry.nameIndex);
+    }
+    return std::nullopt;
+}
+
+std::optional<ImageView::Export> ExportIndex::find(std::string_view name) const {
+    const auto names = directory ? image.RVAtoVA<const uint32_t*>(directory->AddressOfNames) : nullptr;
+    return probe(hash(name), [&](uint32_t nameIndex) { return name == image.RVAtoVA<const char*>(names[nameIndex]); });
+}
+
+std::optional<ImageView::Export> ExportIndex::findByHash(uint64_t nameHash) const {
+    return probe(nameHash, [](uint32_t) { return true; });
+}
+
+std::optional<ImageView::Export> ExportIndex::findByOrdinal(uint32_t ordinal) const {
+    std::call_once(built, &ExportIndex::build, this);
+    if(!directory || ordinal < directory->Base || ordinal - directory->Base >= directory->NumberOfFunctions)
+        return std::nullopt;
+
+    // Unused entries of the export address table are zero
+    const auto functionIndex = ordinal - directory->Base;
+    if(!image.RVAtoVA<const uint32_t*>(directory->AddressOfFunctions)[functionIndex])
+        return std::nullopt;
+
+    return makeExport(functionIndex, functionNames[functionIndex]);
+}
+
+size_t ExportIndex::nameCount() const noexcept {
+    return directory ? directory->NumberOfNames : 0;
+}
+
+ImageView::Export ExportIndex::makeExport(uint32_t functionIndex, uint32_t nameIndex) const noexcept {
+    ImageView::Export result;
+    result.directory     = directory;
+    result.image         = &image;
+    result.functionIndex = functionIndex;
+    result.nameIndex     = nameIndex;
+    return result;
+}
@@ -0,0 +1,44 @@
+#include "FileImageScanner.h"
+#include "Parallel.h"
+
+using namespace B3L;
+
+namespace {
+
+    uint32_t toRVA(const FileImageView& image, int index, const uint8_t* match) {
+        const auto data = image.sectionData(index);
+        return image.section(index)->VirtualAddress + static_cast<uint32_t>(match - data.data());
+    }
+
+} // namespace
+
+std::optional<uint32_t> FileImageScanner::find(const FileImageView& image, const AOBPattern& needle, const SectionFilter& filter) {
+    for(auto index : filter.select(image)) {
+        const auto data = image.sectionData(index);
+
+        const auto match = AOBScanner::find(data.begin(), data.end(), needle);
+        if(match != data.end())
+            return toRVA(image, index, std::to_address(match));
+    }
+    return std::nullopt;
+}
+
+std::vector<uint32_t>
+FileImageScanner::findAll(const FileImageView& image, const AOBPattern& needle, const SectionFilter& filter, unsigned threadCount) {
+    const auto sections = filter.select(image);
+
+    std::vector<std::vector<uint32_t>> sectionMatches(sections.size());
+
+    detail::parallelFor(sections.size(), threadCount, [&](size_t i) {
+        const auto data = image.sectionData(sections[i]);
+
+        for(auto match : AOBScanner::matches(data.begin(), data.end(), needle))
+            sectionMatches[i].push_back(toRVA(image, sections[i], std::to_address(match)));
+    });
+
+    std::vector<uint32_t> matches;
+    for(const auto& section : sectionMatches)
+        matches.insert(matches.end(), section.begin(), section.end());
+
+    return matches;
+}
@@ -0,0 +1,130 @@
+#include "FileImageView.h"
+#include <cstddef>
+
+using namespace B3L;
+
+namespace {
+
+    // Raw data size of a section. A VirtualSize of 0 is used by some linkers and means SizeOfRawData is exact. The
+    // fields are copied since the header may be misaligned.
+    size_t rawDataSize(const PE::SectionHeader& section) noexcept {
+        const uint32_t virtualSize = section.Misc.VirtualSize;
+        const uint32_t rawSize     = section.SizeOfRawData;
+        if(virtualSize == 0)
+            return rawSize;
+        return (std::min)(virtualSize, rawSize);
+    }
+
+    bool fitsInFile(std::span<const uint8_t> file, uint64_t offset, uint64_t size) noexcept {
+        return offset <= file.size() && size <= file.size() - offset;
+    }
+
+} // namespace
+
+std::optional<FileImageView> FileImageView::create(std::span<const uint8_t> data) {
+    // Validate Dos Header
+    if(!fitsInFile(data, 0, sizeof(PE::DosHeader)))
+        return std::nullopt;
+
+    const FileImageView view(data);
+    if(view.dosHeader()->e_magic != PE::dosSignature || view.dosHeader()->e_lfanew < 0)
+        return std::nullopt;
+
+    // Validate Nt Headers
+    const uint64_t ntOffset = view.dosHeader()->e_lfanew;
+    if(!fitsInFile(data, ntOffset, sizeof(uint32_t) + sizeof(PE::FileHeader)))
+        return std::nullopt;
+
+    uint32_t signature;
+    std::copy_n(data.data() + ntOffset, sizeof(signature), reinterpret_cast<uint8_t*>(&signature));
+    if(signature != PE::ntSignature)
+        return std::nullopt;
+
+    // Validate Optional Header, SizeOfHeaders is the last field both layouts need
+    const auto optionalOffset     = ntOffset + sizeof(uint32_t) + sizeof(PE::FileHeader);
+    const auto optionalHeaderSize = view.fileHeader()->SizeOfOptionalHeader;
+    if(!fitsInFile(data, optionalOffset, optionalHeaderSize))
+        return std::nullopt;
+    if(optionalHeaderSize < offsetof(PE::OptionalHeader32, Magic) + sizeof(uint16_t))
+        return std::nullopt;
+
+    const auto magic = view.optionalHeader32()->Magic;
+    if(magic == PE::optionalHeader32Magic) {
+        if(optionalHeaderSize < offsetof(PE::OptionalHeader32, DataDirectory))
+            return std::nullopt;
+    } else if(magic == PE::optionalHeader64Magic) {
+        if(optionalHeaderSize < offsetof(PE::OptionalHeader64, DataDirectory))
+            return std::nullopt;
+    } else {
+        return std::nullopt;
+    }
+
+    // Validate Section Headers
+    const auto sectionOffset = optionalOffset + optionalHeaderSize;
+    if(!fitsInFile(data, sectionOffset, view.sectionCount() * sizeof(PE::SectionHeader)))
+        return std::nullopt;
+
+    for(int i = 0; i < view.sectionCount(); ++i) {
+        const auto section = view.section(i);
+        if(!fitsInFile(data, section->PointerToRawData, rawDataSize(*section)))
+            return std::nullopt;
+    }
+
+    return view;
+}
+
+const PE::DataDirectory* FileImageView::dataDirectory(int index) const noexcept {
+    if(index < 0 || index >= PE::numberOfDirectoryEntries)
+        return nullptr;
+
+    const PE::DataDirectory* directories;
+    uint32_t count;
+    size_t end;
+    if(is64Bit()) {
+        directories = optionalHeader64()->DataDirectory;
+        count       = optionalHeader64()->NumberOfRvaAndSizes;
+        end         = offsetof(PE::OptionalHeader64, DataDirectory) + (index + 1) * sizeof(PE::DataDirectory);
+    } else {
+        directories = optionalHeader32()->DataDirectory;
+        count       = optionalHeader32()->NumberOfRvaAndSizes;
+        end         = offsetof(PE::OptionalHeader32, DataDirectory) + (index + 1) * sizeof(PE::DataDirectory);
+    }
+
+    // The directory has to be both announced and contained in the optional header
+    if(static_cast<uint32_t>(index) >= count || end > fileHeader()->SizeOfOptionalHeader)
+        return nullptr;
+
+    return directories + index;
+}
+
+std::span<const uint8_t> FileImageView::sectionData(int index) const noexcept {
+    auto header = section(index);
+    if(!header)
+        return {};
+
+    return file.subspan(header->PointerToRawData, rawDataSize(*header));
+}
+
+std::optional<size_t> FileImageView::RVAtoOffset(uint64_t rva) const noexcept {
+    if(rva < sizeOfHeaders() && rva < file.size())
+        return static_cast<size_t>(rva);
+
+    for(int i = 0; i < sectionCount(); ++i) {
+        const auto header = section(i);
+        if(rva >= header->VirtualAddress && rva - header->VirtualAddress < rawDataSize(*header))
+            return header->PointerToRawData + static_cast<size_t>(rva - header->VirtualAddress);
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> FileImageView::offsetToRVA(size_t offset) const noexcept {
+    if(offset < sizeOfHeaders() && offset < file.size())
+        return static_cast<uint32_t>(offset);
+
+    for(int i = 0; i < sectionCount(); ++i) {
+        const auto header = section(i);
+        if(offset >= header->PointerToRawData && offset - header->PointerToRawData < rawDataSize(*header))
+            return header->VirtualAddress + static_cast<uint32_t>(offset - header->PointerToRawData);
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,402 @@
+#include "ImageIndex.h"
+#include "Hash.h"
+#include "ImageView.h"
+#include "Parallel.h"
+#include "ScanKernels.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+using namespace B3L;
+
+namespace {
+
+    constexpr uint64_t indexMagic   = 0x31584449474D4942; // "BIMGIDX1"
+    constexpr uint32_t indexVersion = 2;
+
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t sectionCount;
+    };
+
+    struct FileSection {
+        uint64_t address;
+        uint64_t size;
+        uint64_t hash;            // Of the section data
+        uint64_t suffixArrayHash; // Of the stored suffix array, entries that are in range can still be corrupt
+    };
+
+    static_assert(sizeof(FileHeader) == 16);
+    static_assert(sizeof(FileSection) == 32);
+
+    uint64_t hashSuffixArray(const std::vector<uint32_t>& sa) noexcept {
+        return Hash::fnv1a({ reinterpret_cast<const uint8_t*>(sa.data()), sa.size() * sizeof(uint32_t) });
+    }
+
+    // SA-IS (Nong, Zhang and Chan): sorts the LMS suffixes, whose order determines all others through two induced
+    // sorting passes. LMS substrings that are not unique are ranked by sorting the reduced string recursively.
+    // Characters of s are in [0, upper].
+    template <typename Char>
+    std::vector<int32_t> sais(const Char* s, int32_t n, int32_t upper) {
+        std::vector<int32_t> sa(n);
+        if(n == 0)
+            return sa;
+        if(n == 1) {
+            sa[0] = 0;
+            return sa;
+        }
+        if(n == 2) {
+            sa[0] = s[0] < s[1] ? 0 : 1;
+            sa[1] = 1 - sa[0];
+            return sa;
+        }
+
+        // Suffix types, S if smaller than the following suffix
+        std::vector<bool> isS(n);
+        for(auto i = n - 2; i >= 0; --i)
+            isS[i] = s[i] == s[i + 1] ? isS[i + 1] : s[i] < s[i + 1];
+
+        // Bucket starts of the L suffixes and of the S suffixes of each character
+        std::vector<int32_t> startL(upper + 1), startS(upper + 1);
+        for(int32_t i = 0; i < n; ++i) {
+            if(!isS[i])
+                ++startS[s[i]];
+            else
+                ++startL[s[i] + 1];
+        }
+        for(int32_t c = 0; c <= upper; ++c) {
+            startS[c] += startL[c];
+            if(c < upper)
+                startL[c + 1] += startS[c];
+        }
+
+        auto induce = [&](const std::vector<int32_t>& lms) {
+            std::fill(sa.begin(), sa.end(), -1);
+
+            auto bucket = startS;
+            for(auto position : lms)
+                sa[bucket[s[position]]++] = position;
+
+            bucket                 = startL;
+            sa[bucket[s[n - 1]]++] = n - 1;
+            for(int32_t i = 0; i < n; ++i) {
+                const auto position = sa[i];
+                if(position >= 1 && !isS[position - 1])
+                    sa[bucket[s[position - 1]]++] = position - 1;
+            }
+
+            bucket = startL;
+            for(auto i = n - 1; i >= 0; --i) {
+                const auto position = sa[i];
+                if(position >= 1 && isS[position - 1])
+                    sa[--bucket[s[position - 1] + 1]] = position - 1;
+            }
+        };
+
+        // Leftmost S suffixes, numbered in text order
+        std::vector<int32_t> lmsIndex(n, -1);
+        std::vector<int32_t> lms;
+        for(int32_t i = 1; i < n; ++i) {
+            if(!isS[i - 1] && isS[i]) {
+                lmsIndex[i] = static_cast<int32_t>(lms.size());
+                lms.push_back(i);
+            }
+        }
+        const auto lmsCount = static_cast<int32_t>(lms.size());
+
+        induce(lms);
+        if(lmsCount == 0)
+            return sa;
+
+        std::vector<int32_t> sortedLms;
+        sortedLms.reserve(lmsCount);
+        for(auto position : sa) {
+            if(lmsIndex[position] != -1)
+                sortedLms.push_back(position);
+        }
+
+        // Name the LMS substrings, equal substrings share a name
+        std::vector<int32_t> reduced(lmsCount);
+        int32_t name                    = 0;
+        reduced[lmsIndex[sortedLms[0]]] = 0;
+        for(int32_t i = 1; i < lmsCount; ++i) {
+            auto left       = sortedLms[i - 1];
+            auto right      = sortedLms[i];
+            const auto endL = lmsIndex[left] + 1 < lmsCount ? lms[lmsIndex[left] + 1] : n;
+            const auto endR = lmsIndex[right] + 1 < lmsCount ? lms[lmsIndex[right] + 1] : n;
+            bool same       = endL - left == endR - right;
+            if(same) {
+                while(left < endL && s[left] == s[right]) {
+                    ++left;
+                    ++right;
+                }
+                same = left != n && s[left] == s[right];
+            }
+            if(!same)
+                ++name;
+            reduced[lmsIndex[sortedLms[i]]] = name;
+        }
+
+        const auto reducedSa = sais(reduced.data(), lmsCount, name);
+        for(int32_t i = 0; i < lmsCount; ++i)
+            sortedLms[i] = lms[reducedSa[i]];
+
+        induce(sortedLms);
+        return sa;
+    }
+
+    // Compares the suffix at position with needle, skipping the first lcp bytes that are known to be equal. order is
+    // 0 if needle is a prefix of the suffix.
+    struct Comparison {
+        int order;
+        size_t lcp;
+    };
+
+    Comparison compareSuffix(std::span<const uint8_t> data, size_t position, std::span<const uint8_t> needle, size_t lcp) noexcept {
+        const auto available = data.size() - position;
+        const auto limit     = (std::min)(available, needle.size());
+        while(lcp < limit && data[position + lcp] == needle[lcp])
+            ++lcp;
+
+        if(lcp == needle.size())
+            return { 0, lcp };
+        if(lcp == available)
+            return { -1, lcp }; // Suffix is a proper prefix of needle
+        return { data[position + lcp] < needle[lcp] ? -1 : 1, lcp };
+    }
+
+} // namespace
+
+ImageIndex::ImageIndex(std::vector<Section> sections, unsigned threadCount) : indexed(std::move(sections)) {
+    for(const auto& section : indexed) {
+        if(section.data.size() > INT32_MAX)
+            throw std::length_error("Section too large to index");
+    }
+
+    suffixArrays.resize(indexed.size());
+    detail::parallelFor(indexed.size(), threadCount, [&](size_t i) {
+        const auto& data = indexed[i].data;
+        const auto sa    = sais(data.data(), static_cast<int32_t>(data.size()), UINT8_MAX);
+        suffixArrays[i].assign(sa.begin(), sa.end());
+    });
+}
+
+ImageIndex::ImageIndex(std::vector<Section> sections, std::vector<SuffixArray> suffixArrays) noexcept
+: indexed(std::move(sections)), suffixArrays(std::move(suffixArrays)) {}
+
+ImageIndex ImageIndex::fromImage(const ImageView& image, const SectionFilter& filter, unsigned threadCount) {
+    std::vector<Section> sections;
+    for(auto index : filter.select(image))
+        sections.push_back({ image.baseAddress() + image.section(index)->VirtualAddress, image.sectionData(index) });
+
+    return ImageIndex(std::move(sections), threadCount);
+}
+
+ImageIndex ImageIndex::fromFile(const FileImageView& image, const SectionFilter& filter, unsigned threadCount) {
+    std::vector<Section> sections;
+    for(auto index : filter.select(image))
+        sections.push_back({ image.section(index)->VirtualAddress, image.sectionData(index) });
+
+    return ImageIndex(std::move(sections), threadCount);
+}
+
+std::optional<ImageIndex> ImageIndex::load(const std::filesystem::path& path, std::vector<Section> sections) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        return std::nullopt;
+
+    FileHeader header{};
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return std::nullopt;
+    if(header.magic != indexMagic || header.version != indexVersion || header.sectionCount != sections.size())
+        return std::nullopt;
+
+    std::vector<FileSection> records(sections.size());
+    for(size_t i = 0; i < sections.size(); ++i) {
+        auto& record = records[i];
+        if(!file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+            return std::nullopt;
+        if(record.address != sections[i].address || record.size != sections[i].data.size() ||
+           record.hash != Hash::fnv1a(sections[i].data))
+            return std::nullopt;
+    }
+
+    std::vector<SuffixArray> suffixArrays(sections.size());
+    for(size_t i = 0; i < sections.size(); ++i) {
+        auto& sa = suffixArrays[i];
+        sa.resize(sections[i].data.size());
+        if(!file.read(reinterpret_cast<char*>(sa.data()), sa.size() * sizeof(uint32_t)))
+            return std::nullopt; // Truncated file
+
+        if(hashSuffixArray(sa) != records[i].suffixArrayHash)
+            return std::nullopt;
+
+        // A corrupt entry must not make queries read out of bounds
+        if(std::any_of(sa.begin(), sa.end(), [&](uint32_t position) { return position >= sa.size(); }))
+            return std::nullopt;
+    }
+
+    if(file.peek() != std::ifstream::traits_type::eof())
+        return std::nullopt; // Trailing bytes
+
+    return ImageIndex(std::move(sections), std::move(suffixArrays));
+}
+
+void ImageIndex::save(const std::filesystem::path& path) const {
+    const FileHeader header{ indexMagic, indexVersion, static_cast<uint32_t>(indexed.size()) };
+
+    // Write to a temporary file first so that a failed write doesn't destroy a previously saved index
+    auto tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for(size_t i = 0; i < indexed.size(); ++i) {
+            const auto& section = indexed[i];
+            const FileSection record{ section.address, section.data.size(), Hash::fnv1a(section.data),
+                                      hashSuffixArray(suffixArrays[i]) };
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        for(const auto& sa : suffixArrays)
+            file.write(reinterpret_cast<const char*>(sa.data()), sa.size() * sizeof(uint32_t));
+
+        if(!file.flush())
+            throw std::runtime_error("Failed to write image index");
+    }
+    std::filesystem::rename(tempPath, path);
+}
+
+ImageIndex::Range ImageIndex::equalRange(size_t section, std::span<const uint8_t> needle) const noexcept {
+    const auto& data = indexed[section].data;
+    const auto& sa   = suffixArrays[section];
+
+    // Binary search that skips the prefix shared by needle and both bounds, which keeps comparisons near O(m + log n)
+    auto bound = [&](bool upper) {
+        size_t first = 0, last = sa.size();
+        size_t lcpFirst = 0, lcpLast = 0;
+        while(first < last) {
+            const auto middle     = first + (last - first) / 2;
+            const auto comparison = compareSuffix(data, sa[middle], needle, (std::min)(lcpFirst, lcpLast));
+            if(comparison.order < 0 || (upper && comparison.order == 0)) {
+                first    = middle + 1;
+                lcpFirst = comparison.lcp;
+            } else {
+                last    = middle;
+                lcpLast = comparison.lcp;
+            }
+        }
+        return first;
+    };
+
+    if(needle.empty())
+        return { 0, 0 };
+
+    return { bound(false), bound(true) };
+}
+
+std::vector<uint32_t> ImageIndex::matches(size_t section, std::span<const uint8_t> needle) const {
+    const auto range = equalRange(section, needle);
+    const auto& sa   = suffixArrays[section];
+    return { sa.begin() + range.first, sa.begin() + range.last };
+}
+
+std::vector<uint32_t> ImageIndex::matches(size_t section, const AOBPattern& needle) const {
+    const auto value = needle.value();
+    const auto mask  = needle.mask();
+    const auto& data = indexed[section].data;
+
+    std::vector<uint32_t> result;
+    if(data.size() < needle.size())
+        return result;
+
+    // Solid fragment with the fewest occurrences
+    std::optional<Range> best;
+    size_t bestOffset = 0;
+    for(size_t first = 0; first < needle.size();) {
+        if(mask[first] != 0xFF) {
+            ++first;
+            continue;
+        }
+
+        auto last = first;
+        while(last < needle.size() && mask[last] == 0xFF)
+            ++last;
+
+        const auto range = equalRange(section, value.subspan(first, last - first));
+        if(!best || range.size() < best->size()) {
+            best       = range;
+            bestOffset = first;
+        }
+        first = last;
+    }
+
+    // Nothing to look up, scan the section
+    if(!best) {
+        const auto begin = data.data();
+        const auto end   = begin + data.size();
+        for(auto hit = begin; (hit = detail::findPattern(hit, end, needle)) != end; ++hit)
+            result.push_back(static_cast<uint32_t>(hit - begin));
+        return result;
+    }
+
+    const auto& sa = suffixArrays[section];
+    for(auto i = best->first; i < best->last; ++i) {
+        if(sa[i] < bestOffset)
+            continue;
+
+        const auto offset = sa[i] - bestOffset;
+        if(offset + needle.size() <= data.size() && needle.matchesAt(data.data() + offset))
+            result.push_back(static_cast<uint32_t>(offset));
+    }
+    return result;
+}
+
+template <typename Needle>
+std::optional<uint64_t> ImageIndex::firstMatch(const Needle& needle) const {
+    std::optional<uint64_t> first;
+    for(size_t i = 0; i < indexed.size(); ++i) {
+        const auto offsets = matches(i, needle);
+        if(offsets.empty())
+            continue;
+
+        const auto address = indexed[i].address + *std::min_element(offsets.begin(), offsets.end());
+        if(!first || address < *first)
+            first = address;
+    }
+    return first;
+}
+
+template <typename Needle>
+std::vector<uint64_t> ImageIndex::allMatches(const Needle& needle) const {
+    std::vector<uint64_t> result;
+    for(size_t i = 0; i < indexed.size(); ++i) {
+        for(auto offset : matches(i, needle))
+            result.push_back(indexed[i].address + offset);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::optional<uint64_t> ImageIndex::find(std::span<const uint8_t> needle) const {
+    return firstMatch(needle);
+}
+
+std::optional<uint64_t> ImageIndex::find(const AOBPattern& needle) const {
+    return firstMatch(needle);
+}
+
+std::vector<uint64_t> ImageIndex::findAll(std::span<const uint8_t> needle) const {
+    return allMatches(needle);
+}
+
+std::vector<uint64_t> ImageIndex::findAll(const AOBPattern& needle) const {
+    return allMatches(needle);
+}
+
+size_t ImageIndex::count(std::span<const uint8_t> needle) const {
+    size_t total = 0;
+    for(size_t i = 0; i < indexed.size(); ++i)
+        total += equalRange(i, needle).size();
+    return total;
+}
@@ -0,0 +1,269 @@
+#include "ImageMapper.h"
+#include "FileImageView.h"
+#include "MappedFile.h"
+#include "Relocations.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace B3L;
+
+namespace {
+
+    // GetLastError on Windows, errno elsewhere. Read before cleanup calls that may overwrite it.
+    [[nodiscard]] int lastError() noexcept {
+#ifdef _WIN32
+        return static_cast<int>(GetLastError());
+#else
+        return errno;
+#endif
+    }
+
+    [[noreturn]] void throwError(int error, const char* what) {
+        throw std::system_error(error, std::system_category(), what);
+    }
+
+    [[noreturn]] void throwLastError(const char* what) {
+        throwError(lastError(), what);
+    }
+
+    // Throws if the import structures the resolver loop walks leave memory, ImportIterator reads them unchecked and the
+    // IAT entries are written to.
+    void validateImports(const ImageView& image, const MemoryQuery& memory) {
+        const auto directory = image.dataDirectory(PE::DirectoryEntry::Import);
+        if(!directory->VirtualAddress || !directory->Size)
+            return;
+
+        const auto region = memory.query(image.RVAtoVA<const void*>(0));
+        if(!region)
+            throw std::runtime_error("Invalid mapped image");
+        const auto limit = region->base + region->size - image.baseAddress();
+
+        auto contains = [&](uint64_t rva, size_t size) { return rva <= limit && size <= limit - rva; };
+        auto containsString = [&](uint64_t rva) {
+            return rva < limit && std::memchr(image.RVAtoVA<const char*>(rva), 0, limit - rva) != nullptr;
+        };
+
+        for(uint64_t descriptorRVA = directory->VirtualAddress;; descriptorRVA += sizeof(PE::ImportDescriptor)) {
+            if(!contains(descriptorRVA, sizeof(PE::ImportDescriptor)))
+                throw std::runtime_error("Import descriptor outside of image");
+
+            const auto descriptor = image.RVAtoVA<const PE::ImportDescriptor*>(descriptorRVA);
+            if(!descriptor->Name)
+                return;
+            if(!containsString(descriptor->Name))
+                throw std::runtime_error("Import module name outside of image");
+
+            // The name is checked before the terminator, the iterator yields the first thunk even if it terminates
+            for(uint64_t i = 0;; ++i) {
+                const auto lookupRVA = descriptor->OriginalFirstThunk + i * sizeof(PE::ThunkData);
+                const auto entryRVA  = descriptor->FirstThunk + i * sizeof(PE::ThunkData);
+                if(!contains(lookupRVA, sizeof(PE::ThunkData)) || !contains(entryRVA, sizeof(PE::ThunkData)))
+                    throw std::runtime_error("Import thunk outside of image");
+
+                const auto thunk = image.RVAtoVA<const PE::ThunkData*>(lookupRVA);
+                if(!(thunk->u1.Ordinal & PE::ordinalFlag) &&
+                   !containsString(uint64_t{ thunk->u1.AddressOfData } + offsetof(PE::ImportByName, Name)))
+                    throw std::runtime_error("Import name outside of image");
+                if(!thunk->u1.Ordinal)
+                    break;
+            }
+        }
+    }
+
+#ifndef _WIN32
+    // Read only mapping of the file through a descriptor that sections can be mapped from as well. Unmaps and closes
+    // the descriptor once the sections are mapped, their mappings stay valid.
+    class FileMapping {
+        B3L_MAKE_NONCOPYABLE(FileMapping);
+
+    public:
+        explicit FileMapping(const std::filesystem::path& path) : fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+            if(fd < 0)
+                throwLastError("open");
+
+            struct stat status;
+            if(fstat(fd, &status) != 0) {
+                const auto error = lastError();
+                close(fd);
+                throwError(error, "fstat");
+            }
+
+            // Empty files can't be mapped and are rejected as invalid images
+            if(status.st_size == 0)
+                return;
+
+            auto view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(view == MAP_FAILED) {
+                const auto error = lastError();
+                close(fd);
+                throwError(error, "mmap");
+            }
+            contents = { static_cast<const uint8_t*>(view), static_cast<size_t>(status.st_size) };
+        }
+
+        ~FileMapping() {
+            if(!contents.empty())
+                munmap(const_cast<uint8_t*>(contents.data()), contents.size());
+            close(fd);
+        }
+
+        const int fd;
+        std::span<const uint8_t> contents;
+    };
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+ImageMapper::ImageMapper(const std::filesystem::path& path, const ImportResolver& resolver) {
+    const MappedFile file(path);
+    map(file.bytes(), -1, resolver);
+}
+
+#else
+
+ImageMapper::ImageMapper(const std::filesystem::path& path, const ImportResolver& resolver) {
+    const FileMapping file(path);
+    map(file.contents, file.fd, resolver);
+}
+
+#endif
+
+ImageMapper::ImageMapper(std::span<const uint8_t> file, const ImportResolver& resolver) {
+    map(file, -1, resolver);
+}
+
+void ImageMapper::map(std::span<const uint8_t> file, int fileDescriptor, const ImportResolver& resolver) {
+    const auto fileView = FileImageView::create(file);
+    if(!fileView)
+        throw std::runtime_error("Invalid PE file");
+    if(fileView->is64Bit() != PE::native64Bit)
+        throw std::runtime_error("Image doesn't match the process architecture");
+
+    const auto optionalHeader = reinterpret_cast<const PE::OptionalHeader*>(fileView->fileHeader() + 1);
+    const size_t sizeOfImage  = optionalHeader->SizeOfImage;
+    if(sizeOfImage < optionalHeader->SizeOfHeaders)
+        throw std::runtime_error("Invalid SizeOfImage");
+
+#ifdef _WIN32
+    mapping = static_cast<uint8_t*>(VirtualAlloc(nullptr, sizeOfImage, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if(!mapping)
+        throwLastError("VirtualAlloc");
+#else
+    auto view = mmap(nullptr, sizeOfImage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(view == MAP_FAILED)
+        throwLastError("mmap");
+    mapping = static_cast<uint8_t*>(view);
+#endif
+    length = sizeOfImage;
+
+    // The destructor doesn't run for a throwing constructor
+    try {
+        std::memcpy(mapping, file.data(), (std::min)(static_cast<size_t>(optionalHeader->SizeOfHeaders), file.size()));
+
+        for(int i = 0; i < fileView->sectionCount(); ++i)
+            mapSection(*fileView, i, fileDescriptor);
+
+        const std::span<uint8_t> memory(mapping, length);
+        if(!applyRelocations(memory, reinterpret_cast<uintptr_t>(mapping)))
+            throw std::runtime_error("Invalid mapped image");
+
+        const BufferMemoryQuery memoryQuery(memory);
+        image = ImageView::createFromMappedImage(mapping, memoryQuery);
+        if(!image)
+            throw std::runtime_error("Invalid mapped image");
+
+        if(resolver) {
+            validateImports(*image, memoryQuery);
+            for(auto it = image->importsBegin(); it != image->importsEnd(); ++it) {
+                const auto value = resolver(*it);
+                const auto entry = mapping + (reinterpret_cast<const uint8_t*>(it->IATEntryAddress()) - mapping);
+                std::memcpy(entry, &value, sizeof(value));
+            }
+        }
+    } catch(...) {
+        unmap();
+        mapping = nullptr;
+        throw;
+    }
+}
+
+void ImageMapper::mapSection(const FileImageView& file, int index, [[maybe_unused]] int fileDescriptor) {
+    const auto header      = file.section(index);
+    const auto data        = file.sectionData(index);
+    const auto virtualSize = (std::max<size_t>)(header->Misc.VirtualSize, data.size());
+    if(header->VirtualAddress > length || virtualSize > length - header->VirtualAddress)
+        throw std::runtime_error("Section outside of image");
+    if(data.empty())
+        return;
+
+    const auto destination = mapping + header->VirtualAddress;
+
+#ifndef _WIN32
+    const auto pageSize         = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto sectionAlignment = reinterpret_cast<const PE::OptionalHeader*>(file.fileHeader() + 1)->SectionAlignment;
+    if(fileDescriptor >= 0 && sectionAlignment >= pageSize && header->VirtualAddress % pageSize == 0 &&
+       header->PointerToRawData % pageSize == 0) {
+        const auto size = (data.size() + pageSize - 1) / pageSize * pageSize;
+        const auto view =
+        mmap(destination, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileDescriptor, header->PointerToRawData);
+        if(view == MAP_FAILED)
+            throwLastError("mmap");
+
+        // The last page continues with whatever follows the section in the file
+        std::memset(destination + data.size(), 0, size - data.size());
+        return;
+    }
+#endif
+
+    std::memcpy(destination, data.data(), data.size());
+}
+
+#ifdef _WIN32
+
+void ImageMapper::unmap() noexcept {
+    if(mapping)
+        VirtualFree(mapping, 0, MEM_RELEASE);
+}
+
+#else
+
+void ImageMapper::unmap() noexcept {
+    if(mapping)
+        munmap(mapping, length);
+}
+
+#endif
+
+ImageMapper::ImageMapper(ImageMapper&& other) noexcept
+: mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)),
+  image(std::exchange(other.image, std::nullopt)) {
+}
+
+ImageMapper& ImageMapper::operator=(ImageMapper&& other) noexcept {
+    if(this != &other) {
+        unmap();
+        mapping = std::exchange(other.mapping, nullptr);
+        length  = std::exchange(other.length, 0);
+        image   = std::exchange(other.image, std::nullopt);
+    }
+    return *this;
+}
+
+ImageMapper::~ImageMapper() {
+    unmap();
+}
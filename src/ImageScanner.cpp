@@ -0,0 +1,35 @@
+#include "ImageScanner.h"
+#include "Parallel.h"
+
+using namespace B3L;
+
+std::optional<uintptr_t> ImageScanner::find(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter) {
+    for(auto index : filter.select(image)) {
+        const auto data = image.sectionData(index);
+
+        const auto match = AOBScanner::find(data.begin(), data.end(), needle);
+        if(match != data.end())
+            return rcast<uintptr_t>(std::to_address(match));
+    }
+    return std::nullopt;
+}
+
+std::vector<uintptr_t>
+ImageScanner::findAll(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter, unsigned threadCount) {
+    const auto sections = filter.select(image);
+
+    std::vector<std::vector<uintptr_t>> sectionMatches(sections.size());
+
+    detail::parallelFor(sections.size(), threadCount, [&](size_t i) {
+        const auto data = image.sectionData(sections[i]);
+
+        for(auto match : AOBScanner::matches(data.begin(), data.end(), needle))
+            sectionMatches[i].push_back(rcast<uintptr_t>(std::to_address(match)));
+    });
+
+    std::vector<uintptr_t> matches;
+    for(const auto& section : sectionMatches)
+        matches.insert(matches.end(), section.begin(), section.end());
+
+    return matches;
+}
@@ -0,0 +1,85 @@
+#include "ImportIndex.h"
+#include <algorithm>
+#include <bit>
+
+using namespace B3L;
+
+namespace {
+
+    char toLower(char c) noexcept {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // ASCII only, matching Hash::fnv1aLower.
+    bool iequal(std::string_view a, const char* b) noexcept {
+        for(auto c : a) {
+            if(!*b || toLower(c) != toLower(*b++))
+                return false;
+        }
+        return !*b;
+    }
+
+} // namespace
+
+void ImportIndex::build() const {
+    for(auto it = image.importsBegin(); it != image.importsEnd(); ++it)
+        imports.push_back(*it);
+
+    // At most half full, which keeps probe sequences short
+    slots.resize(std::bit_ceil(std::max<size_t>(2 * imports.size(), 8)));
+
+    const auto mask        = slots.size() - 1;
+    uint64_t module        = 0;
+    const char* moduleName = nullptr;
+    for(uint32_t position = 0; position < imports.size(); ++position) {
+        const auto& import = imports[position];
+
+        // Imports are grouped by module
+        if(import.moduleName() != moduleName) {
+            moduleName = import.moduleName();
+            module     = moduleHash(moduleName);
+        }
+
+        const auto symbol  = import.importedByName() ? nameHash(import.name()) : ordinalSymbol(import.ordinal());
+        const auto slotKey = key(module, symbol);
+
+        auto slot = slotKey & mask;
+        while(slots[slot].position != empty)
+            slot = (slot + 1) & mask;
+        slots[slot] = { slotKey, position };
+    }
+}
+
+template <typename Matches>
+std::optional<ImageView::Import> ImportIndex::probe(uint64_t slotKey, Matches&& matches) const {
+    std::call_once(built, &ImportIndex::build, this);
+
+    // Equal keys are probed in insertion order, so the first match is the first in the import directory
+    const auto mask = slots.size() - 1;
+    for(auto slot = slotKey & mask; slots[slot].position != empty; slot = (slot + 1) & mask) {
+        const auto& entry = slots[slot];
+        if(entry.key == slotKey && matches(imports[entry.position]))
+            return imports[entry.position];
+    }
+    return std::nullopt;
+}
+
+std::optional<ImageView::Import> ImportIndex::find(std::string_view module, std::string_view name) const {
+    return probe(key(moduleHash(module), nameHash(name)), [&](const ImageView::Import& import) {
+        return import.importedByName() && name == import.name() && iequal(module, import.moduleName());
+    });
+}
+
+std::optional<ImageView::Import> ImportIndex::find(std::string_view module, int ordinal) const {
+    if(ordinal < 0 || ordinal > UINT16_MAX)
+        return std::nullopt;
+
+    return probe(key(moduleHash(module), ordinalSymbol(ordinal)), [&](const ImageView::Import& import) {
+        return import.ordinal() == ordinal && iequal(module, import.moduleName());
+    });
+}
+
+size_t ImportIndex::size() const {
+    std::call_once(built, &ImportIndex::build, this);
+    return imports.size();
+}
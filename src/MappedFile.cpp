@@ -0,0 +1,133 @@
+#include "MappedFile.h"
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace B3L;
+
+namespace {
+
+    // GetLastError on Windows, errno elsewhere. Read before cleanup calls that may overwrite it.
+    [[nodiscard]] int lastError() noexcept {
+#ifdef _WIN32
+        return static_cast<int>(GetLastError());
+#else
+        return errno;
+#endif
+    }
+
+    [[noreturn]] void throwError(int error, const char* what) {
+        throw std::system_error(error, std::system_category(), what);
+    }
+
+    [[noreturn]] void throwLastError(const char* what) {
+        throwError(lastError(), what);
+    }
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        throwLastError("CreateFileW");
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize)) {
+        const auto error = lastError();
+        CloseHandle(file);
+        throwError(error, "GetFileSizeEx");
+    }
+
+    // Empty files can't be mapped
+    if(fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    auto fileMapping        = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const auto mappingError = lastError();
+    CloseHandle(file);
+    if(!fileMapping)
+        throwError(mappingError, "CreateFileMappingW");
+
+    // The view keeps the mapping object alive
+    auto view            = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    const auto viewError = lastError();
+    CloseHandle(fileMapping);
+    if(!view)
+        throwError(viewError, "MapViewOfFile");
+
+    mapping = static_cast<const uint8_t*>(view);
+    length  = static_cast<size_t>(fileSize.QuadPart);
+}
+
+void MappedFile::unmap() noexcept {
+    if(mapping)
+        UnmapViewOfFile(mapping);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        throwLastError("open");
+
+    struct stat status;
+    if(fstat(fd, &status) != 0) {
+        const auto error = lastError();
+        close(fd);
+        throwError(error, "fstat");
+    }
+
+    // Empty files can't be mapped
+    if(status.st_size == 0) {
+        close(fd);
+        return;
+    }
+
+    // The mapping stays valid after closing the descriptor
+    auto view            = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    const auto viewError = lastError();
+    close(fd);
+    if(view == MAP_FAILED)
+        throwError(viewError, "mmap");
+
+    mapping = static_cast<const uint8_t*>(view);
+    length  = static_cast<size_t>(status.st_size);
+}
+
+void MappedFile::unmap() noexcept {
+    if(mapping)
+        munmap(const_cast<uint8_t*>(mapping), length);
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+        unmap();
+        mapping = std::exchange(other.mapping, nullptr);
+        length  = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
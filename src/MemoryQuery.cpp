@@ -0,0 +1,69 @@
+#include "MemoryQuery.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <cinttypes>
+    #include <cstdio>
+    #include <fstream>
+    #include <string>
+#endif
+
+using namespace B3L;
+
+namespace {
+
+#ifdef _WIN32
+
+    class VirtualMemoryQuery final : public MemoryQuery {
+    public:
+        std::optional<MemoryRegion> query(const void* address) const override {
+            MEMORY_BASIC_INFORMATION info;
+            if(!VirtualQuery(address, &info, sizeof(info)) || info.State == MEM_FREE)
+                return std::nullopt;
+
+            return MemoryRegion{ reinterpret_cast<uintptr_t>(info.BaseAddress), info.RegionSize, info.State == MEM_COMMIT };
+        }
+    };
+
+#else
+
+    // Reads the maps file on every query, the layout changes with every allocation.
+    class ProcMapsMemoryQuery final : public MemoryQuery {
+    public:
+        std::optional<MemoryRegion> query(const void* address) const override {
+            const auto target = reinterpret_cast<uintptr_t>(address);
+
+            std::ifstream maps("/proc/self/maps");
+
+            // Format: begin-end perms offset dev inode [path], ascending
+            std::string line;
+            while(std::getline(maps, line)) {
+                uint64_t begin = 0, end = 0;
+                char perms[5]  = {};
+                if(std::sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %4s", &begin, &end, perms) != 3)
+                    continue;
+                if(target < begin)
+                    break;
+                if(target >= end)
+                    continue;
+
+                const bool accessible = perms[0] != '-' || perms[1] != '-' || perms[2] != '-';
+                return MemoryRegion{ static_cast<uintptr_t>(begin), static_cast<size_t>(end - begin), accessible };
+            }
+            return std::nullopt;
+        }
+    };
+
+#endif
+
+} // namespace
+
+const MemoryQuery& MemoryQuery::native() {
+#ifdef _WIN32
+    static const VirtualMemoryQuery query;
+#else
+    static const ProcMapsMemoryQuery query;
+#endif
+    return query;
+}
@@ -0,0 +1,172 @@
+#include "MultiPatternScanner.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace B3L;
+
+namespace {
+
+    bool isExact(const AOBPattern& pattern, int index) {
+        return index >= 0 && index < static_cast<int>(pattern.size()) && pattern.mask()[index] == 0xFF;
+    }
+
+    // Offset of the first byte of an exact byte pair, preferably one containing the primary anchor. -1 if there is none.
+    int selectPairAnchor(const AOBPattern& pattern) {
+        const auto anchor = pattern.primaryAnchor();
+        if(isExact(pattern, anchor) && isExact(pattern, anchor + 1))
+            return anchor;
+        if(isExact(pattern, anchor - 1) && isExact(pattern, anchor))
+            return anchor - 1;
+
+        for(int i = 0; i + 1 < static_cast<int>(pattern.size()); ++i) {
+            if(isExact(pattern, i) && isExact(pattern, i + 1))
+                return i;
+        }
+        return -1;
+    }
+
+    uint32_t pairKey(uint8_t first, uint8_t second) {
+        return first | (static_cast<uint32_t>(second) << 8);
+    }
+
+    template <typename Table, typename Keys>
+    void fillTable(Table& table, const Keys& keys) {
+        for(const auto& [key, entry] : keys)
+            ++table.offsets[key + 1];
+
+        for(size_t i = 1; i < table.offsets.size(); ++i)
+            table.offsets[i] += table.offsets[i - 1];
+
+        std::vector<uint32_t> cursor(table.offsets.begin(), table.offsets.end() - 1);
+        table.entries.resize(keys.size());
+        for(const auto& [key, entry] : keys)
+            table.entries[cursor[key]++] = entry;
+    }
+
+} // namespace
+
+MultiPatternScanner::MultiPatternScanner(std::vector<AOBPattern> patterns) : patterns(std::move(patterns)) {
+    buildTables();
+}
+
+void MultiPatternScanner::buildTables() {
+    std::vector<std::pair<uint32_t, Entry>> pairKeys;
+    std::vector<std::pair<uint32_t, Entry>> byteKeys;
+
+    for(uint32_t id = 0; id < patterns.size(); ++id) {
+        const auto& pattern = patterns[id];
+        const auto value    = pattern.value();
+        const auto mask     = pattern.mask();
+
+        if(auto anchor = selectPairAnchor(pattern); anchor >= 0) {
+            const auto key = pairKey(value[anchor], value[anchor + 1]);
+            pairKeys.emplace_back(key, Entry{ id, static_cast<uint32_t>(anchor) });
+        } else if(auto single = pattern.primaryAnchor(); single >= 0) {
+            // Partially masked anchors are registered under every byte they match
+            for(uint32_t b = 0; b < 0x100; ++b) {
+                if((b & mask[single]) == value[single])
+                    byteKeys.emplace_back(b, Entry{ id, static_cast<uint32_t>(single) });
+            }
+        } else {
+            wildcard.push_back(id);
+        }
+    }
+
+    fillTable(pairTable, pairKeys);
+    fillTable(byteTable, byteKeys);
+
+    pairFilter.assign(pairTable.offsets.size() / 64, 0);
+    for(const auto& [key, entry] : pairKeys)
+        pairFilter[key / 64] |= uint64_t{ 1 } << (key % 64);
+}
+
+template <typename OnMatch>
+void MultiPatternScanner::sweep(std::span<const uint8_t> haystack, OnMatch&& onMatch) const {
+    const auto size = haystack.size();
+    const auto data = haystack.data();
+
+    auto verify = [&](const Entry& entry, size_t anchorPos) {
+        if(anchorPos < entry.anchorOffset)
+            return true;
+
+        const auto offset   = anchorPos - entry.anchorOffset;
+        const auto& pattern = patterns[entry.patternId];
+        if(pattern.size() > size - offset)
+            return true;
+
+        return !pattern.matchesAt(data + offset) || onMatch(entry.patternId, offset);
+    };
+
+    const bool haveByteEntries = !byteTable.entries.empty();
+
+    for(size_t pos = 0; pos < size; ++pos) {
+        if(pos + 1 < size) {
+            const auto key = pairKey(data[pos], data[pos + 1]);
+            if(pairFilter[key / 64] & (uint64_t{ 1 } << (key % 64))) {
+                for(auto i = pairTable.offsets[key]; i < pairTable.offsets[key + 1]; ++i) {
+                    if(!verify(pairTable.entries[i], pos))
+                        return;
+                }
+            }
+        }
+
+        if(haveByteEntries) {
+            const auto key = data[pos];
+            for(auto i = byteTable.offsets[key]; i < byteTable.offsets[key + 1]; ++i) {
+                if(!verify(byteTable.entries[i], pos))
+                    return;
+            }
+        }
+
+        for(auto id : wildcard) {
+            if(patterns[id].size() <= size - pos && !onMatch(id, pos))
+                return;
+        }
+    }
+}
+
+std::vector<MultiPatternScanner::Match> MultiPatternScanner::scan(std::span<const uint8_t> haystack) const {
+    std::vector<Match> matches;
+    sweep(haystack, [&](size_t patternId, size_t offset) {
+        matches.push_back({ patternId, offset });
+        return true;
+    });
+
+    // Matches are found in order of their anchor position, not their offset.
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.patternId < b.patternId;
+    });
+    return matches;
+}
+
+std::vector<std::optional<uint64_t>> MultiPatternScanner::resolve(std::span<const uint8_t> haystack, uint64_t baseAddress) const {
+    std::vector<std::optional<uint64_t>> results(patterns.size());
+    auto unresolved = patterns.size();
+    if(!unresolved)
+        return results;
+
+    sweep(haystack, [&](size_t patternId, size_t offset) {
+        auto& result = results[patternId];
+        if(!result) {
+            result = patterns[patternId].resolve(haystack.data() + offset, baseAddress + offset);
+            --unresolved;
+        }
+        return unresolved != 0;
+    });
+    return results;
+}
+
+std::vector<std::optional<uint64_t>> MultiPatternScanner::resolve(std::span<const uint8_t> haystack) const {
+    return resolve(haystack, reinterpret_cast<uintptr_t>(haystack.data()));
+}
+
+size_t MultiPatternScanner::patternCount() const noexcept {
+    return patterns.size();
+}
+
+const AOBPattern& MultiPatternScanner::pattern(size_t patternId) const {
+    if(patternId >= patterns.size())
+        throw std::out_of_range("Invalid pattern id");
+
+    return patterns[patternId];
+}
@@ -0,0 +1,33 @@
+#include "Parallel.h"
+
+using namespace B3L::detail;
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(size_t count, const std::function<void()>& task) {
+    {
+        const std::lock_guard lock(mutex);
+        tasks.insert(tasks.end(), count, task);
+        while(threads.size() < count)
+            threads.emplace_back([this](std::stop_token stop) { run(stop); });
+    }
+    available.notify_all();
+}
+
+void ThreadPool::run(std::stop_token stop) {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            if(!available.wait(lock, stop, [&] { return !tasks.empty(); }))
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
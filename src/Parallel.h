@@ -0,0 +1,104 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace B3L::detail {
+
+    // Resolves a requested thread count of 0 to the number of hardware threads.
+    [[nodiscard]] inline unsigned resolveThreadCount(unsigned threadCount) noexcept {
+        if(threadCount)
+            return threadCount;
+        return (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    // Process wide pool of worker threads that live until exit. Threads are started on demand, so the pool grows to the
+    // largest number of tasks that were submitted at once.
+    class ThreadPool {
+    public:
+        [[nodiscard]] static ThreadPool& instance();
+
+        // Queues count copies of task, starting threads until at least count exist.
+        void submit(size_t count, const std::function<void()>& task);
+
+    private:
+        ThreadPool() = default;
+
+        void run(std::stop_token stop);
+
+        std::mutex mutex;
+        std::condition_variable_any available;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::jthread> threads; // Declared last, joined before the queue is destroyed
+    };
+
+    // Invokes fn(index) for all indices in [0, count) on up to threadCount workers. Workers pull indices in ascending
+    // order so that early indices are always processed first. The calling thread participates as one of the workers,
+    // the others are taken from ThreadPool. The first exception thrown by fn stops the remaining indices from being
+    // handed out and is rethrown once all workers are done.
+    template <typename Fn>
+    void parallelFor(size_t count, unsigned threadCount, Fn&& fn) {
+        const auto workerCount = (std::min)(static_cast<size_t>(resolveThreadCount(threadCount)), count);
+        if(workerCount <= 1) {
+            for(size_t index = 0; index < count; ++index)
+                fn(index);
+            return;
+        }
+
+        // Shared with the pool tasks, which may only start after the caller returned if the pool is busy
+        struct State {
+            std::atomic<size_t> next{ 0 };
+            std::mutex mutex;
+            std::condition_variable done;
+            size_t active = 0;    // Pool tasks between start and finish
+            bool closed   = false; // Set once the caller finished its own share, later tasks return right away
+            std::exception_ptr error;
+        };
+        const auto state = std::make_shared<State>();
+
+        auto worker = [&fn, count, &state = *state]() {
+            try {
+                for(size_t index = state.next++; index < count; index = state.next++)
+                    fn(index);
+            } catch(...) {
+                state.next = count;
+                const std::lock_guard lock(state.mutex);
+                if(!state.error)
+                    state.error = std::current_exception();
+            }
+        };
+
+        ThreadPool::instance().submit(workerCount - 1, [state, &worker]() {
+            {
+                const std::lock_guard lock(state->mutex);
+                if(state->closed)
+                    return;
+                ++state->active;
+            }
+
+            worker();
+
+            const std::lock_guard lock(state->mutex);
+            if(--state->active == 0)
+                state->done.notify_all();
+        });
+
+        worker();
+
+        std::unique_lock lock(state->mutex);
+        state->closed = true;
+        state->done.wait(lock, [&] { return state->active == 0; });
+
+        if(state->error)
+            std::rethrow_exception(state->error);
+    }
+
+} // namespace B3L::detail
@@ -0,0 +1,200 @@
+#include "Relocations.h"
+#include "ImageView.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+using namespace B3L;
+
+namespace {
+
+    using Entry = ImageView::RelocationBlock;
+
+    constexpr size_t pageSize = 0x1000;
+
+    struct Block {
+        uint32_t pageRVA;
+        std::span<const uint16_t> entries;
+    };
+
+    struct Headers {
+        size_t imageBase;     // Offset of ImageBase in the image
+        size_t imageBaseSize; // 4 for PE32, 8 for PE32+
+        PE::DataDirectory relocations;
+    };
+
+    bool fitsInImage(std::span<const uint8_t> image, uint64_t offset, uint64_t size) noexcept {
+        return offset <= image.size() && size <= image.size() - offset;
+    }
+
+    template <typename OptionalHeader>
+    std::optional<Headers> readOptionalHeader(std::span<const uint8_t> image, size_t offset, size_t size) noexcept {
+        if(size < offsetof(OptionalHeader, DataDirectory))
+            return std::nullopt;
+
+        Headers headers{ offset + offsetof(OptionalHeader, ImageBase), sizeof(OptionalHeader::ImageBase), {} };
+
+        uint32_t count;
+        std::memcpy(&count, image.data() + offset + offsetof(OptionalHeader, NumberOfRvaAndSizes), sizeof(count));
+
+        // The directory has to be both announced and contained in the optional header
+        constexpr auto index = PE::DirectoryEntry::BaseReloc;
+        const auto end       = offsetof(OptionalHeader, DataDirectory) + (index + 1) * sizeof(PE::DataDirectory);
+        if(static_cast<uint32_t>(index) < count && end <= size) {
+            const auto directory = image.data() + offset + end - sizeof(PE::DataDirectory);
+            std::memcpy(&headers.relocations, directory, sizeof(PE::DataDirectory));
+            if(!fitsInImage(image, headers.relocations.VirtualAddress, headers.relocations.Size))
+                return std::nullopt;
+        }
+        return headers;
+    }
+
+    // Locates ImageBase and the base relocation directory in either optional header layout, like FileImageView.
+    // Returns std::nullopt if the headers are invalid or the directory extends past the image.
+    std::optional<Headers> readHeaders(std::span<const uint8_t> image) noexcept {
+        PE::DosHeader dos;
+        if(!fitsInImage(image, 0, sizeof(dos)))
+            return std::nullopt;
+        std::memcpy(&dos, image.data(), sizeof(dos));
+        if(dos.e_magic != PE::dosSignature || dos.e_lfanew < 0)
+            return std::nullopt;
+
+        uint32_t signature;
+        PE::FileHeader fileHeader;
+        const uint64_t ntOffset = dos.e_lfanew;
+        if(!fitsInImage(image, ntOffset, sizeof(signature) + sizeof(fileHeader)))
+            return std::nullopt;
+        std::memcpy(&signature, image.data() + ntOffset, sizeof(signature));
+        std::memcpy(&fileHeader, image.data() + ntOffset + sizeof(signature), sizeof(fileHeader));
+        if(signature != PE::ntSignature)
+            return std::nullopt;
+
+        const auto optionalOffset = static_cast<size_t>(ntOffset) + sizeof(signature) + sizeof(fileHeader);
+        const auto optionalSize   = fileHeader.SizeOfOptionalHeader;
+        if(!fitsInImage(image, optionalOffset, optionalSize) || optionalSize < sizeof(uint16_t))
+            return std::nullopt;
+
+        uint16_t magic;
+        std::memcpy(&magic, image.data() + optionalOffset, sizeof(magic));
+        if(magic == PE::optionalHeader32Magic)
+            return readOptionalHeader<PE::OptionalHeader32>(image, optionalOffset, optionalSize);
+        if(magic == PE::optionalHeader64Magic)
+            return readOptionalHeader<PE::OptionalHeader64>(image, optionalOffset, optionalSize);
+        return std::nullopt;
+    }
+
+    template <typename T>
+    void add(uint8_t* field, T delta) noexcept {
+        T value;
+        std::memcpy(&value, field, sizeof(value));
+        value += delta;
+        std::memcpy(field, &value, sizeof(value));
+    }
+
+    // Applies a single entry if its field lies within the first available bytes of the page.
+    void relocate(uint8_t* page, size_t available, uint16_t entry, uint64_t delta) noexcept {
+        const auto offset = Entry::offset(entry);
+        switch(Entry::type(entry)) {
+            case PE::RelocationType::HighLow:
+                if(offset + sizeof(uint32_t) <= available)
+                    add(page + offset, static_cast<uint32_t>(delta));
+                break;
+            case PE::RelocationType::Dir64:
+                if(offset + sizeof(uint64_t) <= available)
+                    add(page + offset, delta);
+                break;
+        }
+    }
+
+    // Fields of the page must not extend past the image, i.e. available covers the page and the widest field.
+    void relocatePage(uint8_t* page, std::span<const uint16_t> entries, uint64_t delta) noexcept {
+        size_t i = 0;
+
+#ifdef B3L_HAVE_SSE2
+        // 64 bit images are mostly DIR64 entries, often in runs of adjacent fields such as vtables and pointer arrays.
+        // Eight entries are classified at once, runs are added 16 bytes at a time.
+        const auto dir64  = _mm_set1_epi16(PE::RelocationType::Dir64);
+        const auto steps  = _mm_setr_epi16(0, 8, 16, 24, 32, 40, 48, 56);
+        const auto deltas = _mm_set1_epi64x(static_cast<int64_t>(delta));
+
+        for(; i + 8 <= entries.size(); i += 8) {
+            const auto block   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entries.data() + i));
+            const auto types   = _mm_srli_epi16(block, 12);
+            const auto offsets = _mm_and_si128(block, _mm_set1_epi16(0x0FFF));
+
+            if(_mm_movemask_epi8(_mm_cmpeq_epi16(types, dir64)) != 0xFFFF) {
+                for(size_t j = i; j < i + 8; ++j)
+                    relocate(page, pageSize + sizeof(uint64_t), entries[j], delta);
+                continue;
+            }
+
+            const auto first    = Entry::offset(entries[i]);
+            const auto expected = _mm_add_epi16(_mm_set1_epi16(static_cast<int16_t>(first)), steps);
+            if(_mm_movemask_epi8(_mm_cmpeq_epi16(offsets, expected)) == 0xFFFF) {
+                const auto run = page + first;
+                for(size_t j = 0; j < 4; ++j) {
+                    const auto fields = _mm_loadu_si128(reinterpret_cast<const __m128i*>(run + 16 * j));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(run + 16 * j), _mm_add_epi64(fields, deltas));
+                }
+            } else {
+                for(size_t j = i; j < i + 8; ++j)
+                    add(page + Entry::offset(entries[j]), delta);
+            }
+        }
+#endif
+
+        for(; i < entries.size(); ++i)
+            relocate(page, pageSize + sizeof(uint64_t), entries[i], delta);
+    }
+
+} // namespace
+
+bool B3L::applyRelocations(std::span<uint8_t> image, uint64_t newBase, unsigned threadCount) {
+    // Headers are read by Magic rather than through ImageView, which only accepts the native layout
+    const auto headers = readHeaders(image);
+    if(!headers)
+        return false;
+
+    uint64_t oldBase = 0;
+    std::memcpy(&oldBase, image.data() + headers->imageBase, headers->imageBaseSize);
+    if(headers->imageBaseSize == sizeof(uint32_t) && newBase > UINT32_MAX)
+        return false;
+
+    const auto delta = newBase - oldBase;
+    if(delta && headers->relocations.Size) {
+        std::vector<Block> blocks;
+        const auto directory = image.subspan(headers->relocations.VirtualAddress, headers->relocations.Size);
+        for(size_t pos = 0; directory.size() - pos >= sizeof(PE::BaseRelocation);) {
+            PE::BaseRelocation header;
+            std::memcpy(&header, directory.data() + pos, sizeof(header));
+            if(header.SizeOfBlock < sizeof(header) || header.SizeOfBlock > directory.size() - pos)
+                break;
+
+            const auto entries = rcast<const uint16_t*>(directory.data() + pos + sizeof(header));
+            const auto count   = (header.SizeOfBlock - sizeof(header)) / sizeof(uint16_t);
+            blocks.push_back({ header.VirtualAddress, { entries, count } });
+            pos += header.SizeOfBlock;
+        }
+
+        detail::parallelFor(blocks.size(), threadCount, [&](size_t index) {
+            const auto& block = blocks[index];
+            if(block.pageRVA >= image.size())
+                return;
+
+            const auto page      = image.data() + block.pageRVA;
+            const auto available = image.size() - block.pageRVA;
+            if(available >= pageSize + sizeof(uint64_t)) {
+                relocatePage(page, block.entries, delta);
+            } else {
+                for(auto entry : block.entries)
+                    relocate(page, available, entry, delta);
+            }
+        });
+    }
+
+    std::memcpy(image.data() + headers->imageBase, &newBase, headers->imageBaseSize);
+    return true;
+}
@@ -0,0 +1,190 @@
+#include "RemoteMemorySource.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <cinttypes>
+    #include <climits>
+    #include <csignal>
+    #include <cstdio>
+    #include <fstream>
+    #include <string>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+using namespace B3L;
+
+namespace {
+
+    // Remote addresses are 64 bit wide independent of the pointer size of the current process
+    void* toPointer(uint64_t address) noexcept {
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(address));
+    }
+
+} // namespace
+
+#ifdef _WIN32
+
+RemoteMemorySource::RemoteMemorySource(ProcessId processId) : pid(processId) {
+    process = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, processId);
+    if(!process)
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "OpenProcess");
+}
+
+RemoteMemorySource::~RemoteMemorySource() {
+    if(process)
+        CloseHandle(process);
+}
+
+RemoteMemorySource::RemoteMemorySource(RemoteMemorySource&& other) noexcept
+: pid(other.pid), process(std::exchange(other.process, nullptr)) {
+}
+
+RemoteMemorySource& RemoteMemorySource::operator=(RemoteMemorySource&& other) noexcept {
+    if(this != &other) {
+        if(process)
+            CloseHandle(process);
+        pid     = other.pid;
+        process = std::exchange(other.process, nullptr);
+    }
+    return *this;
+}
+
+std::vector<RemoteMemorySource::Region> RemoteMemorySource::regions() const {
+    constexpr DWORD unreadable = PAGE_NOACCESS | PAGE_GUARD;
+
+    std::vector<Region> result;
+
+    MEMORY_BASIC_INFORMATION info;
+    for(uint64_t address = 0; VirtualQueryEx(process, toPointer(address), &info, sizeof(info));
+        address = reinterpret_cast<uintptr_t>(info.BaseAddress) + info.RegionSize) {
+        if(info.State == MEM_COMMIT && !(info.Protect & unreadable))
+            result.push_back({ reinterpret_cast<uintptr_t>(info.BaseAddress), info.RegionSize });
+    }
+    return result;
+}
+
+size_t RemoteMemorySource::read(std::span<const Region> ranges, uint8_t* buffer, std::span<size_t> bytesRead) const {
+    assert(bytesRead.size() >= ranges.size());
+
+    size_t total = 0;
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        SIZE_T count = 0;
+        if(!ReadProcessMemory(process, toPointer(ranges[i].address), buffer, ranges[i].size, &count) &&
+           GetLastError() != ERROR_PARTIAL_COPY)
+            count = 0;
+
+        bytesRead[i] = count;
+        total += count;
+        buffer += ranges[i].size;
+    }
+    return total;
+}
+
+#else
+
+namespace {
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    // process_vm_readv transfers whole iovec elements only, a single unreadable page fails its entire range.
+    // Reads a failed range page by page to recover its readable prefix.
+    size_t readPagewise(ProcessId pid, const RemoteMemorySource::Region& range, uint8_t* buffer) {
+        size_t count = 0;
+        while(count < range.size) {
+            const auto address = range.address + count;
+            const auto size    = (std::min)(range.size - count, pageSize - static_cast<size_t>(address % pageSize));
+
+            iovec local{ buffer + count, size };
+            iovec remote{ toPointer(address), size };
+            if(process_vm_readv(pid, &local, 1, &remote, 1, 0) != static_cast<ssize_t>(size))
+                break;
+            count += size;
+        }
+        return count;
+    }
+
+} // namespace
+
+RemoteMemorySource::RemoteMemorySource(ProcessId processId) : pid(processId) {
+    // There is no handle to open, only check that the process exists. Missing access rights surface as failed reads.
+    if(kill(pid, 0) != 0 && errno != EPERM)
+        throw std::system_error(errno, std::system_category(), "kill");
+}
+
+RemoteMemorySource::~RemoteMemorySource()                                               = default;
+RemoteMemorySource::RemoteMemorySource(RemoteMemorySource&& other) noexcept            = default;
+RemoteMemorySource& RemoteMemorySource::operator=(RemoteMemorySource&& other) noexcept = default;
+
+std::vector<RemoteMemorySource::Region> RemoteMemorySource::regions() const {
+    std::vector<Region> result;
+
+    std::ifstream maps("/proc/" + std::to_string(pid) + "/maps");
+    if(!maps)
+        throw std::system_error(errno, std::system_category(), "open /proc/pid/maps");
+
+    // Format: begin-end perms offset dev inode [path]
+    std::string line;
+    while(std::getline(maps, line)) {
+        uint64_t begin = 0, end = 0;
+        char perms[5]  = {};
+        if(std::sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %4s", &begin, &end, perms) != 3 || perms[0] != 'r')
+            continue;
+
+        // Not readable through process_vm_readv
+        if(line.ends_with("[vvar]") || line.ends_with("[vsyscall]"))
+            continue;
+
+        result.push_back({ begin, static_cast<size_t>(end - begin) });
+    }
+    return result;
+}
+
+size_t RemoteMemorySource::read(std::span<const Region> ranges, uint8_t* buffer, std::span<size_t> bytesRead) const {
+    assert(bytesRead.size() >= ranges.size());
+
+    std::vector<iovec> remote;
+    remote.reserve((std::min)(ranges.size(), static_cast<size_t>(IOV_MAX)));
+
+    size_t total = 0;
+    size_t first = 0;
+    while(first < ranges.size()) {
+        // Transfer as many ranges as possible with one call
+        const auto last = (std::min)(ranges.size(), first + IOV_MAX);
+
+        remote.clear();
+        size_t size = 0;
+        for(auto i = first; i < last; ++i) {
+            remote.push_back({ toPointer(ranges[i].address), ranges[i].size });
+            size += ranges[i].size;
+        }
+
+        iovec local{ buffer, size };
+        const auto count = process_vm_readv(pid, &local, 1, remote.data(), remote.size(), 0);
+
+        // Ranges are transferred either completely or not at all, the transfer stops at the first failing range
+        auto transferred = count > 0 ? static_cast<size_t>(count) : 0;
+        for(; first < last && transferred >= ranges[first].size; ++first) {
+            bytesRead[first] = ranges[first].size;
+            transferred -= ranges[first].size;
+            total += ranges[first].size;
+            buffer += ranges[first].size;
+        }
+
+        if(first < last) {
+            bytesRead[first] = readPagewise(pid, ranges[first], buffer);
+            total += bytesRead[first];
+            buffer += ranges[first].size;
+            ++first;
+        }
+    }
+    return total;
+}
+
+#endif
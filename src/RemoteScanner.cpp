@@ -0,0 +1,168 @@
+#include "RemoteScanner.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <thread>
+
+using namespace B3L;
+
+namespace {
+
+    using Region = RemoteMemorySource::Region;
+
+    // Ranges of one or more regions that are read with a single call.
+    struct Block {
+        std::vector<Region> ranges;
+        size_t size = 0;
+    };
+
+    // Splits regions into ranges of at most blockSize bytes and packs them into blocks. Ranges of the same region
+    // overlap by needle size - 1 bytes so that matches crossing range borders are found exactly once.
+    std::vector<Block> planBlocks(std::span<const Region> regions, size_t needleSize, size_t blockSize) {
+        const auto step = blockSize - (needleSize - 1);
+
+        std::vector<Block> blocks(1);
+        auto addRange = [&](Region range) {
+            if(blocks.back().size + range.size > blockSize)
+                blocks.emplace_back();
+            blocks.back().ranges.push_back(range);
+            blocks.back().size += range.size;
+        };
+
+        for(const auto& region : regions) {
+            if(region.size < needleSize)
+                continue;
+
+            for(size_t offset = 0;; offset += step) {
+                const auto size = (std::min)(blockSize, region.size - offset);
+                addRange({ region.address + offset, size });
+                if(offset + size == region.size)
+                    break;
+            }
+        }
+
+        if(blocks.back().ranges.empty())
+            blocks.pop_back();
+        return blocks;
+    }
+
+    struct BlockData {
+        std::vector<uint8_t> buffer;
+        std::vector<size_t> bytesRead;
+    };
+
+    void readBlock(const RemoteMemorySource& source, const Block& block, BlockData& data) {
+        data.buffer.resize(block.size);
+        data.bytesRead.assign(block.ranges.size(), 0);
+        source.read(block.ranges, data.buffer.data(), data.bytesRead);
+    }
+
+    // Reads the blocks in order on a single long lived thread. Two buffers alternate between the reader and the
+    // scanning thread, block i + 2 is only read into the buffer of block i once that one was released.
+    class BlockReader {
+    public:
+        BlockReader(const RemoteMemorySource& source, std::span<const Block> blocks)
+        : source(source), blocks(blocks), thread([this](std::stop_token stop) { run(stop); }) {
+        }
+
+        // Waits until block index was read. Rethrows if reading it failed.
+        const BlockData& acquire(size_t index) {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return readCount > index || error; });
+            if(readCount <= index)
+                std::rethrow_exception(error);
+            return buffers[index % 2];
+        }
+
+        // Hands the buffer of block index back to the reader.
+        void release(size_t index) {
+            {
+                const std::lock_guard lock(mutex);
+                releasedCount = index + 1;
+            }
+            changed.notify_all();
+        }
+
+    private:
+        void run(std::stop_token stop) {
+            for(size_t i = 0; i < blocks.size(); ++i) {
+                {
+                    std::unique_lock lock(mutex);
+                    if(!changed.wait(lock, stop, [&] { return i < releasedCount + 2; }))
+                        return;
+                }
+
+                try {
+                    readBlock(source, blocks[i], buffers[i % 2]);
+                } catch(...) {
+                    const std::lock_guard lock(mutex);
+                    error = std::current_exception();
+                    changed.notify_all();
+                    return;
+                }
+
+                {
+                    const std::lock_guard lock(mutex);
+                    readCount = i + 1;
+                }
+                changed.notify_all();
+            }
+        }
+
+        const RemoteMemorySource& source;
+        const std::span<const Block> blocks;
+        BlockData buffers[2];
+
+        std::mutex mutex;
+        std::condition_variable_any changed;
+        size_t readCount     = 0;
+        size_t releasedCount = 0;
+        std::exception_ptr error;
+
+        std::jthread thread; // Declared last, joined before the buffers are destroyed
+    };
+
+    void scanBlock(const Block& block, const BlockData& data, const AOBPattern& needle, std::vector<uint64_t>& matches) {
+        const uint8_t* begin = data.buffer.data();
+        for(size_t i = 0; i < block.ranges.size(); ++i) {
+            const auto end = begin + data.bytesRead[i];
+            for(auto pos = begin; (pos = detail::findPattern(pos, end, needle)) != end; ++pos)
+                matches.push_back(block.ranges[i].address + (pos - begin));
+
+            begin += block.ranges[i].size;
+        }
+    }
+
+} // namespace
+
+std::vector<uint64_t> RemoteScanner::findAll(const RemoteMemorySource& source, const AOBPattern& needle, size_t blockSize) {
+    const auto regions = source.regions();
+    return findAll(source, regions, needle, blockSize);
+}
+
+std::vector<uint64_t> RemoteScanner::findAll(const RemoteMemorySource& source,
+                                             std::span<const RemoteMemorySource::Region> regions,
+                                             const AOBPattern& needle,
+                                             size_t blockSize) {
+    std::vector<uint64_t> matches;
+    if(needle.size() == 0)
+        return matches;
+
+    // Ranges have to advance by at least one byte
+    blockSize = (std::max)(blockSize, needle.size() * 2);
+
+    const auto blocks = planBlocks(regions, needle.size(), blockSize);
+    if(blocks.empty())
+        return matches;
+
+    // Double buffering: block i + 1 is read while block i is scanned
+    BlockReader reader(source, blocks);
+    for(size_t i = 0; i < blocks.size(); ++i) {
+        scanBlock(blocks[i], reader.acquire(i), needle, matches);
+        reader.release(i);
+    }
+
+    return matches;
+}
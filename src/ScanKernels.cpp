@@ -0,0 +1,360 @@
+#include "ScanKernels.h"
+#include "Simd.h"
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+using namespace B3L;
+using namespace B3L::detail;
+
+namespace {
+
+    bool matchesAt(const uint8_t* data, const ScanPlan& plan) noexcept {
+        return detail::matchesAt(data, plan.value, plan.mask, plan.size);
+    }
+
+    // Verifies all candidates in a compare mask of a block starting at pos. Returns nullptr if none matches.
+    const uint8_t* verifyCandidates(uint32_t mask, const uint8_t* pos, const ScanPlan& plan) noexcept {
+        while(mask) {
+            const auto candidate = pos + std::countr_zero(mask);
+            if(matchesAt(candidate, plan))
+                return candidate;
+            mask &= mask - 1;
+        }
+        return nullptr;
+    }
+
+    // Scans candidate positions [pos, last] with memchr on the primary anchor if it is fully masked.
+    const uint8_t* findScalar(const uint8_t* pos, const uint8_t* last, const uint8_t* end, const ScanPlan& plan) noexcept {
+        const auto anchor = plan.primaryAnchor;
+        if(plan.mask[anchor] != 0xFF) {
+            for(; pos <= last; ++pos) {
+                if(matchesAt(pos, plan))
+                    return pos;
+            }
+            return end;
+        }
+
+        const auto value = plan.value[anchor];
+        while(pos <= last) {
+            auto hit = static_cast<const uint8_t*>(std::memchr(pos + anchor, value, last - pos + 1));
+            if(!hit)
+                break;
+
+            auto candidate = hit - anchor;
+            if(matchesAt(candidate, plan))
+                return candidate;
+            pos = candidate + 1;
+        }
+        return end;
+    }
+
+#ifdef B3L_HAVE_SSE2
+    const uint8_t* findSse2(const uint8_t* pos, const uint8_t* last, const uint8_t* end, const ScanPlan& plan) noexcept {
+        const auto a0 = plan.primaryAnchor;
+        const auto a1 = plan.secondaryAnchor;
+
+        const auto v0 = _mm_set1_epi8(static_cast<char>(plan.value[a0]));
+        const auto v1 = _mm_set1_epi8(static_cast<char>(plan.value[a1]));
+        const auto m0 = _mm_set1_epi8(static_cast<char>(plan.mask[a0]));
+        const auto m1 = _mm_set1_epi8(static_cast<char>(plan.mask[a1]));
+
+        constexpr ptrdiff_t blockSize = 16;
+        for(; last - pos >= blockSize - 1; pos += blockSize) {
+            const auto b0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + a0)), m0);
+            const auto b1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + a1)), m1);
+            const auto eq = _mm_and_si128(_mm_cmpeq_epi8(b0, v0), _mm_cmpeq_epi8(b1, v1));
+
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+            if(auto match = verifyCandidates(mask, pos, plan))
+                return match;
+        }
+        return findScalar(pos, last, end, plan);
+    }
+
+    B3L_TARGET_AVX2 const uint8_t*
+    findAvx2(const uint8_t* pos, const uint8_t* last, const uint8_t* end, const ScanPlan& plan) noexcept {
+        const auto a0 = plan.primaryAnchor;
+        const auto a1 = plan.secondaryAnchor;
+
+        const auto v0 = _mm256_set1_epi8(static_cast<char>(plan.value[a0]));
+        const auto v1 = _mm256_set1_epi8(static_cast<char>(plan.value[a1]));
+        const auto m0 = _mm256_set1_epi8(static_cast<char>(plan.mask[a0]));
+        const auto m1 = _mm256_set1_epi8(static_cast<char>(plan.mask[a1]));
+
+        constexpr ptrdiff_t blockSize = 32;
+        for(; last - pos >= blockSize - 1; pos += blockSize) {
+            const auto b0 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + a0)), m0);
+            const auto b1 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + a1)), m1);
+            const auto eq = _mm256_and_si256(_mm256_cmpeq_epi8(b0, v0), _mm256_cmpeq_epi8(b1, v1));
+
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+            if(auto match = verifyCandidates(mask, pos, plan))
+                return match;
+        }
+        return findSse2(pos, last, end, plan);
+    }
+#endif
+
+    // Checks a window whose last byte matched. The last 16 bytes are compared at once before the full verify, which
+    // rejects most windows of long patterns early.
+    bool verifyWindow(const uint8_t* pos, const ScanPlan& plan) noexcept {
+#ifdef B3L_HAVE_SSE2
+        if(plan.size >= 16) {
+            const auto offset = plan.size - 16;
+            const auto bytes  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + offset));
+            const auto mask   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.mask + offset));
+            const auto value  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.value + offset));
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, mask), value)) != 0xFFFF)
+                return false;
+        }
+#endif
+        return matchesAt(pos, plan);
+    }
+
+    // Scans candidate positions [pos, last] with Horspool skipping.
+    const uint8_t*
+    findHorspool(const uint8_t* pos, const uint8_t* last, const uint8_t* end, const ScanPlan& plan, const uint32_t* skip) noexcept {
+        const auto size = plan.size;
+        const auto tail = plan.value[size - 1];
+
+        while(pos <= last) {
+            const auto current = pos[size - 1];
+            if(current == tail && verifyWindow(pos, plan))
+                return pos;
+
+            const auto shift = skip[current];
+            if(static_cast<size_t>(last - pos) < shift)
+                break;
+            pos += shift;
+        }
+        return end;
+    }
+
+    // Horspool on interleaved lanes. Every shift depends on a load of the previous window, a single lane is bound by
+    // that latency. Lanes cover consecutive ranges of start positions and advance in lockstep, so their loads overlap.
+    const uint8_t* findHorspoolInterleaved(
+    const uint8_t* begin, const uint8_t* last, const uint8_t* end, const ScanPlan& plan, const uint32_t* skip) noexcept {
+        constexpr size_t laneCount = 8;
+
+        const auto size = plan.size;
+        const auto tail = plan.value[size - 1];
+
+        // Short ranges don't amortize the lane setup
+        const auto positions = static_cast<size_t>(last - begin) + 1;
+        if(positions < laneCount * 16 * size)
+            return findHorspool(begin, last, end, plan, skip);
+
+        const uint8_t* pos[laneCount];
+        const uint8_t* lanesLast[laneCount];
+        for(size_t i = 0; i < laneCount; ++i) {
+            pos[i]       = begin + positions * i / laneCount;
+            lanesLast[i] = begin + positions * (i + 1) / laneCount - 1;
+        }
+
+        // Matches of a lane precede those of all later lanes, which stop once an earlier lane matched
+        const uint8_t* match[laneCount] = {};
+        size_t activeCount              = laneCount;
+        bool active[laneCount]          = { true, true, true, true, true, true, true, true };
+
+        while(activeCount) {
+            for(size_t i = 0; i < laneCount; ++i) {
+                if(!active[i])
+                    continue;
+
+                const auto current = pos[i][size - 1];
+                if(current == tail && verifyWindow(pos[i], plan)) {
+                    match[i] = pos[i];
+                    for(size_t j = i; j < laneCount; ++j) {
+                        activeCount -= active[j];
+                        active[j] = false;
+                    }
+                    break;
+                }
+
+                const auto shift = skip[current];
+                if(static_cast<size_t>(lanesLast[i] - pos[i]) < shift) {
+                    active[i] = false;
+                    --activeCount;
+                } else {
+                    pos[i] += shift;
+                }
+            }
+        }
+
+        for(auto candidate : match) {
+            if(candidate)
+                return candidate;
+        }
+        return end;
+    }
+
+} // namespace
+
+Anchors B3L::detail::selectAnchors(const uint8_t* value,
+                                   const uint8_t* mask,
+                                   size_t size,
+                                   const ByteFrequencyTable& frequencies) noexcept {
+    Anchors anchors;
+
+    double primaryProbability = 1.0;
+    for(int i = 0; i < static_cast<int>(size); ++i) {
+        if(!mask[i])
+            continue;
+
+        const auto probability = frequencies.matchProbability(value[i], mask[i]);
+        if(anchors.primary < 0 || probability < primaryProbability) {
+            anchors.primary    = i;
+            primaryProbability = probability;
+        }
+    }
+
+    if(anchors.primary < 0)
+        return anchors;
+
+    anchors.secondary           = anchors.primary;
+    double secondaryProbability = 1.0;
+    for(int i = 0; i < static_cast<int>(size); ++i) {
+        if(!mask[i] || i == anchors.primary)
+            continue;
+
+        const auto probability = frequencies.matchProbability(value[i], mask[i]);
+        const auto farther     = std::abs(i - anchors.primary) > std::abs(anchors.secondary - anchors.primary);
+        if(anchors.secondary == anchors.primary || probability < secondaryProbability ||
+           (probability == secondaryProbability && farther)) {
+            anchors.secondary    = i;
+            secondaryProbability = probability;
+        }
+    }
+    return anchors;
+}
+
+size_t B3L::detail::exactSuffixBegin(const ScanPlan& plan) noexcept {
+    size_t begin = plan.size;
+    while(begin > 0 && plan.mask[begin - 1] == 0xFF)
+        --begin;
+    return begin;
+}
+
+void B3L::detail::buildSkipTable(const ScanPlan& plan, std::array<uint32_t, 256>& skip) noexcept {
+    const auto size        = plan.size;
+    const auto suffixBegin = exactSuffixBegin(plan);
+
+    // Largest shift that can't skip over an alignment at which a non-exact byte is aligned with the window end.
+    skip.fill(static_cast<uint32_t>(size - suffixBegin));
+
+    for(size_t i = suffixBegin; i + 1 < size; ++i)
+        skip[plan.value[i]] = static_cast<uint32_t>(size - 1 - i);
+}
+
+const uint8_t* B3L::detail::scan(const uint8_t* begin, const uint8_t* end, const ScanPlan& plan, ScanStrategy strategy) noexcept {
+    const auto size = plan.size;
+    if(size == 0)
+        return begin;
+    if(static_cast<size_t>(end - begin) < size)
+        return end;
+
+    // Pattern consists of wildcards only and matches everywhere
+    if(plan.primaryAnchor < 0)
+        return begin;
+
+    // Last position at which a match can start
+    const auto last = end - size;
+
+    if(strategy == ScanStrategy::Horspool && plan.mask[size - 1] == 0xFF) {
+        if(plan.skip)
+            return findHorspoolInterleaved(begin, last, end, plan, plan.skip);
+
+        std::array<uint32_t, 256> skip;
+        buildSkipTable(plan, skip);
+        return findHorspoolInterleaved(begin, last, end, plan, skip.data());
+    }
+
+#ifdef B3L_HAVE_SSE2
+    if(cpuSupportsAvx2())
+        return findAvx2(begin, last, end, plan);
+    return findSse2(begin, last, end, plan);
+#else
+    return findScalar(begin, last, end, plan);
+#endif
+}
+
+size_t B3L::detail::countMismatches(const uint8_t* data, const ScanPlan& plan, size_t limit) noexcept {
+    size_t count = 0;
+    size_t i     = 0;
+
+#ifdef B3L_HAVE_SSE2
+    for(; i + 16 <= plan.size; i += 16) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto mask  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.mask + i));
+        const auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.value + i));
+        const auto eq    = _mm_cmpeq_epi8(_mm_and_si128(bytes, mask), value);
+
+        count += std::popcount(~static_cast<uint32_t>(_mm_movemask_epi8(eq)) & 0xFFFF);
+        if(count > limit)
+            return count;
+    }
+#endif
+
+    for(; i < plan.size; ++i)
+        count += (data[i] & plan.mask[i]) != plan.value[i];
+    return count;
+}
+
+void B3L::detail::findApproximate(const uint8_t* begin,
+                                  const uint8_t* end,
+                                  const ScanPlan& plan,
+                                  size_t maxMismatches,
+                                  std::vector<ApproximateMatch>& matches) {
+    const auto size = plan.size;
+    if(size == 0 || static_cast<size_t>(end - begin) < size)
+        return;
+
+    // Last position at which a match can start
+    const auto last = end - size;
+    auto pos        = begin;
+
+#ifdef B3L_HAVE_SSE2
+    // Wildcards never mismatch, only columns of masked bytes are compared
+    std::vector<size_t> columns;
+    for(size_t i = 0; i < size; ++i) {
+        if(plan.mask[i])
+            columns.push_back(i);
+    }
+
+    // Lanes count matching columns, a start position matches if at least required columns match
+    if(columns.size() <= 0xFF) {
+        const auto required  = columns.size() > maxMismatches ? columns.size() - maxMismatches : 0;
+        const auto threshold = _mm_set1_epi8(static_cast<char>(required));
+
+        for(; last - pos >= 15; pos += 16) {
+            auto matching = _mm_setzero_si128();
+            for(auto column : columns) {
+                const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + column));
+                const auto mask  = _mm_set1_epi8(static_cast<char>(plan.mask[column]));
+                const auto value = _mm_set1_epi8(static_cast<char>(plan.value[column]));
+                matching         = _mm_sub_epi8(matching, _mm_cmpeq_epi8(_mm_and_si128(bytes, mask), value));
+            }
+
+            // Unsigned matching >= required
+            const auto accepted = _mm_cmpeq_epi8(_mm_max_epu8(matching, threshold), matching);
+            auto lanes          = static_cast<uint32_t>(_mm_movemask_epi8(accepted));
+            if(!lanes)
+                continue;
+
+            alignas(16) uint8_t counts[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(counts), matching);
+            for(; lanes; lanes &= lanes - 1) {
+                const auto lane = std::countr_zero(lanes);
+                matches.push_back({ pos + lane, columns.size() - counts[lane] });
+            }
+        }
+    }
+#endif
+
+    for(; pos <= last; ++pos) {
+        const auto mismatches = countMismatches(pos, plan, maxMismatches);
+        if(mismatches <= maxMismatches)
+            matches.push_back({ pos, mismatches });
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "AOBScanner.h"
+#include "ByteFrequencyTable.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace B3L::detail {
+
+    // Pattern and precomputed scan parameters shared by AOBPattern and CompiledPattern.
+    struct ScanPlan {
+        const uint8_t* value = nullptr;
+        const uint8_t* mask  = nullptr;
+        size_t size          = 0;
+        int primaryAnchor    = -1; // -1 if the pattern consists of wildcards only
+        int secondaryAnchor  = -1;
+        const uint32_t* skip = nullptr; // Horspool shift table, computed on the fly if nullptr
+    };
+
+    [[nodiscard]] inline ScanPlan makeScanPlan(const AOBPattern& needle) noexcept {
+        return { needle.value().data(), needle.mask().data(), needle.size(), needle.primaryAnchor(), needle.secondaryAnchor() };
+    }
+
+    // Branch-free masked compare, the loop vectorizes.
+    [[nodiscard]] inline bool matchesAt(const uint8_t* data, const uint8_t* value, const uint8_t* mask, size_t size) noexcept {
+        uint8_t diff = 0;
+        for(size_t i = 0; i < size; ++i)
+            diff |= static_cast<uint8_t>((data[i] & mask[i]) ^ value[i]);
+        return diff == 0;
+    }
+
+    struct Anchors {
+        int primary   = -1;
+        int secondary = -1;
+    };
+
+    // Selects the byte least likely to match according to frequencies as primary anchor and the next least likely one
+    // as secondary. Ties are broken towards the first byte and the byte farthest from the primary anchor respectively.
+    [[nodiscard]] Anchors
+    selectAnchors(const uint8_t* value, const uint8_t* mask, size_t size, const ByteFrequencyTable& frequencies) noexcept;
+
+    // Offset of the longest suffix consisting of exact bytes only. Equals size if the last byte isn't exact.
+    [[nodiscard]] size_t exactSuffixBegin(const ScanPlan& plan) noexcept;
+
+    // Fills skip with the Horspool shift for every value of the last window byte. Only considers the exact suffix,
+    // since any other byte might match every haystack byte.
+    void buildSkipTable(const ScanPlan& plan, std::array<uint32_t, 256>& skip) noexcept;
+
+    // Returns pointer to the first match in [begin, end) or end if there is none. Horspool is only used if the last
+    // pattern byte is exact.
+    [[nodiscard]] const uint8_t* scan(const uint8_t* begin, const uint8_t* end, const ScanPlan& plan, ScanStrategy strategy) noexcept;
+
+    // Number of pattern bytes that don't match the bytes at data. Stops counting once limit is exceeded.
+    [[nodiscard]] size_t countMismatches(const uint8_t* data, const ScanPlan& plan, size_t limit) noexcept;
+
+    // Appends every match with at most maxMismatches mismatched bytes starting in [begin, end - plan.size] in address
+    // order. Compares every start position, 16 at a time.
+    void findApproximate(const uint8_t* begin,
+                         const uint8_t* end,
+                         const ScanPlan& plan,
+                         size_t maxMismatches,
+                         std::vector<ApproximateMatch>& matches);
+
+} // namespace B3L::detail
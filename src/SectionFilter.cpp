@@ -0,0 +1,25 @@
+#include "SectionFilter.h"
+#include <algorithm>
+
+using namespace B3L;
+
+SectionFilter SectionFilter::executable() {
+    SectionFilter filter;
+    filter.requiredCharacteristics = PE::SectionCharacteristics::MemExecute;
+    return filter;
+}
+
+SectionFilter SectionFilter::named(std::string name) {
+    SectionFilter filter;
+    filter.names.push_back(std::move(name));
+    return filter;
+}
+
+bool SectionFilter::accepts(uint32_t characteristics, std::string_view name) const {
+    if((characteristics & requiredCharacteristics) != requiredCharacteristics)
+        return false;
+    if(characteristics & excludedCharacteristics)
+        return false;
+
+    return names.empty() || std::find(names.begin(), names.end(), name) != names.end();
+}
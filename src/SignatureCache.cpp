@@ -0,0 +1,139 @@
+#include "SignatureCache.h"
+#include "Hash.h"
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace B3L;
+
+namespace {
+
+    constexpr uint64_t cacheMagic   = 0x31434749534C3342; // "B3LSIGC1"
+    constexpr uint32_t cacheVersion = 1;
+
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t count;
+    };
+
+    struct FileRecord {
+        uint64_t key;
+        uint32_t timestamp;
+        uint32_t sizeOfImage;
+        uint64_t sectionHash;
+        uint32_t rva;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 24);
+    static_assert(sizeof(FileRecord) == 32);
+
+    uint64_t filterHash(const SectionFilter& filter) {
+        auto hash = Hash::fnv1aValue(filter.requiredCharacteristics);
+        hash      = Hash::fnv1aValue(filter.excludedCharacteristics, hash);
+        for(const auto& name : filter.names) {
+            hash = Hash::fnv1a(name, hash);
+            hash = Hash::fnv1aValue('\0', hash); // Separator, {"ab", "c"} and {"a", "bc"} must not collide
+        }
+        return hash;
+    }
+
+    uint64_t signatureKey(const AOBPattern& needle, const SectionFilter& filter) {
+        return Hash::fnv1aValue(filterHash(filter), needle.hash());
+    }
+
+} // namespace
+
+ImageIdentity ImageIdentity::of(const ImageView& image) {
+    ImageIdentity identity;
+    identity.timestamp   = image.timestamp();
+    identity.sizeOfImage = image.optionalHeader()->SizeOfImage;
+
+    identity.sectionHash = Hash::fnv1aOffsetBasis;
+    for(int i = 0; i < image.sectionCount(); ++i)
+        identity.sectionHash = Hash::fnv1aValue(*image.section(i), identity.sectionHash);
+
+    return identity;
+}
+
+SignatureCache::SignatureCache(std::filesystem::path path) : path(std::move(path)) {
+    load();
+}
+
+std::optional<uint32_t> SignatureCache::resolve(const ImageView& image, const AOBPattern& needle, const SectionFilter& filter) {
+    const auto key      = signatureKey(needle, filter);
+    const auto identity = ImageIdentity::of(image);
+
+    if(auto it = entries.find(key); it != entries.end()) {
+        const auto& entry = it->second;
+        if(entry.identity == identity && size_t{ entry.rva } + needle.size() <= identity.sizeOfImage) {
+            if(needle.matchesAt(image.RVAtoVA<const uint8_t*>(entry.rva)))
+                return entry.rva;
+        }
+    }
+
+    auto address = ImageScanner::find(image, needle, filter);
+    if(!address)
+        return std::nullopt;
+
+    const auto rva = static_cast<uint32_t>(*address - image.baseAddress());
+    entries[key]   = { identity, rva };
+    dirty          = true;
+
+    return rva;
+}
+
+void SignatureCache::save() {
+    if(!dirty)
+        return;
+
+    std::vector<FileRecord> records;
+    records.reserve(entries.size());
+    for(const auto& [key, entry] : entries)
+        records.push_back({ key, entry.identity.timestamp, entry.identity.sizeOfImage, entry.identity.sectionHash, entry.rva, 0 });
+
+    const FileHeader header{ cacheMagic, cacheVersion, 0, records.size() };
+
+    // Write to a temporary file first so readers never observe a partially written cache
+    auto tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(FileRecord));
+        if(!file.flush())
+            throw std::runtime_error("Failed to write signature cache");
+    }
+    std::filesystem::rename(tempPath, path);
+
+    dirty = false;
+}
+
+size_t SignatureCache::size() const noexcept {
+    return entries.size();
+}
+
+void SignatureCache::load() {
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        return;
+
+    FileHeader header{};
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return;
+    if(header.magic != cacheMagic || header.version != cacheVersion)
+        return;
+
+    std::vector<FileRecord> records;
+    for(uint64_t i = 0; i < header.count; ++i) {
+        FileRecord record{};
+        if(!file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+            return; // Truncated file, discard all entries
+        records.push_back(record);
+    }
+
+    for(const auto& record : records)
+        entries[record.key] = { { record.timestamp, record.sizeOfImage, record.sectionHash }, record.rva };
+}
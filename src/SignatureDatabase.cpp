@@ -0,0 +1,282 @@
+#include "SignatureDatabase.h"
+#include "Simd.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+using namespace B3L;
+
+namespace {
+
+    std::string_view trim(std::string_view str) noexcept {
+        while(!str.empty() && detail::isPatternWhitespace(str.front()))
+            str.remove_prefix(1);
+        while(!str.empty() && detail::isPatternWhitespace(str.back()))
+            str.remove_suffix(1);
+        return str;
+    }
+
+    struct Fields {
+        std::string_view name;
+        std::string_view pattern;
+        std::string_view section;
+        std::string_view module;
+    };
+
+    // "name | pattern [| section [| module]]"
+    bool parseTextLine(std::string_view line, Fields& fields) noexcept {
+        std::string_view* const targets[] = { &fields.name, &fields.pattern, &fields.section, &fields.module };
+
+        size_t count = 0;
+        for(size_t pos = 0; pos <= line.size(); ++count) {
+            if(count == std::size(targets))
+                return false;
+
+            auto separator = line.find('|', pos);
+            if(separator == std::string_view::npos)
+                separator = line.size();
+
+            *targets[count] = trim(line.substr(pos, separator - pos));
+            pos             = separator + 1;
+        }
+        return count >= 2;
+    }
+
+    // Flat JSON object with string members. Escape sequences are rejected since the fields are views into the source,
+    // unknown members are ignored.
+    bool parseJsonLine(std::string_view line, Fields& fields) noexcept {
+        size_t pos = 0;
+
+        auto skipWhitespace = [&]() {
+            while(pos < line.size() && detail::isPatternWhitespace(line[pos]))
+                ++pos;
+        };
+
+        auto consume = [&](char c) {
+            skipWhitespace();
+            if(pos >= line.size() || line[pos] != c)
+                return false;
+            ++pos;
+            return true;
+        };
+
+        auto quoted = [&](std::string_view& result) {
+            if(!consume('"'))
+                return false;
+
+            const auto close = line.find_first_of("\"\\", pos);
+            if(close == std::string_view::npos || line[close] != '"')
+                return false;
+
+            result = line.substr(pos, close - pos);
+            pos    = close + 1;
+            return true;
+        };
+
+        if(!consume('{'))
+            return false;
+
+        skipWhitespace();
+        if(pos < line.size() && line[pos] == '}') {
+            ++pos;
+        } else {
+            do {
+                std::string_view key, value;
+                if(!quoted(key) || !consume(':') || !quoted(value))
+                    return false;
+
+                if(key == "name")
+                    fields.name = value;
+                else if(key == "pattern")
+                    fields.pattern = value;
+                else if(key == "section")
+                    fields.section = value;
+                else if(key == "module")
+                    fields.module = value;
+            } while(consume(','));
+
+            if(!consume('}'))
+                return false;
+        }
+
+        skipWhitespace();
+        return pos == line.size();
+    }
+
+    // Decodes a pattern string into value and mask, which grow as needed. Patterns in the usual "8B ?? 4? " layout are
+    // decoded five bytes at a time with SSE2, anything else is left to detail::parsePattern from where the layout
+    // breaks. onCapture is called as by detail::parsePattern, only if the pattern is valid. Returns the number of
+    // pattern bytes.
+    template <typename OnCapture>
+    std::optional<size_t>
+    decodePattern(std::string_view str, std::vector<uint8_t>& value, std::vector<uint8_t>& mask, OnCapture onCapture) {
+        size_t count = 0;
+        size_t pos   = 0;
+
+#ifdef B3L_HAVE_SSE2
+        // Every byte decoded here takes 3 characters
+        if(value.size() < str.size() / 3) {
+            value.resize(str.size() / 3);
+            mask.resize(str.size() / 3);
+        }
+
+        constexpr int nibbleLanes = 0x36DB; // Lanes 0, 1, 3, 4, ... 12, 13
+        constexpr int spaceLanes  = 0x4924; // Lanes 2, 5, ... 14
+
+        const auto zero  = _mm_set1_epi8('0' - 1);
+        const auto nine  = _mm_set1_epi8('9' + 1);
+        const auto lower = _mm_set1_epi8('a' - 1);
+        const auto upper = _mm_set1_epi8('f' + 1);
+
+        while(pos + 16 <= str.size()) {
+            const auto chars  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+            const auto folded = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+            const auto digit    = _mm_and_si128(_mm_cmpgt_epi8(chars, zero), _mm_cmplt_epi8(chars, nine));
+            const auto letter   = _mm_and_si128(_mm_cmpgt_epi8(folded, lower), _mm_cmplt_epi8(folded, upper));
+            const auto wildcard = _mm_cmpeq_epi8(chars, _mm_set1_epi8('?'));
+            const auto space    = _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '));
+            const auto hex      = _mm_or_si128(digit, letter);
+
+            // Lane 15 has to start the next byte, an explicit mask of the fifth byte may follow after whitespace
+            const auto valid = _mm_movemask_epi8(_mm_or_si128(hex, wildcard));
+            if((valid & (nibbleLanes | 0x8000)) != (nibbleLanes | 0x8000) ||
+               (_mm_movemask_epi8(space) & spaceLanes) != spaceLanes)
+                break;
+
+            const auto nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                                              _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+            const auto masks   = _mm_and_si128(hex, _mm_set1_epi8(0x0F));
+
+            alignas(16) std::array<uint8_t, 16> nibbleBytes, maskBytes;
+            _mm_store_si128(reinterpret_cast<__m128i*>(nibbleBytes.data()), nibbles);
+            _mm_store_si128(reinterpret_cast<__m128i*>(maskBytes.data()), masks);
+
+            for(size_t i = 0; i < 5; ++i, ++count) {
+                value[count] = static_cast<uint8_t>(nibbleBytes[3 * i] << 4 | nibbleBytes[3 * i + 1]);
+                mask[count]  = static_cast<uint8_t>(maskBytes[3 * i] << 4 | maskBytes[3 * i + 1]);
+            }
+            pos += 15;
+        }
+#endif
+
+        const auto rest = trim(str.substr(pos));
+        if(rest.empty())
+            return count ? std::optional(count) : std::nullopt;
+
+        const auto restCount = detail::parsePattern(rest);
+        if(!restCount)
+            return std::nullopt;
+
+        if(value.size() < count + *restCount) {
+            value.resize(count + *restCount);
+            mask.resize(count + *restCount);
+        }
+        auto onRestCapture = [&](const detail::CaptureMarker& marker, size_t offset) {
+            onCapture(marker, count + offset);
+        };
+        detail::parsePattern(rest, value.data() + count, mask.data() + count, onRestCapture);
+        return count + *restCount;
+    }
+
+} // namespace
+
+SectionFilter SignatureDatabase::Signature::sectionFilter() const {
+    if(section.empty())
+        return {};
+    return SectionFilter::named(std::string(section));
+}
+
+SignatureDatabase::SignatureDatabase(std::string_view text) {
+    parse(text);
+}
+
+SignatureDatabase::SignatureDatabase(MappedFile mappedFile) : file(std::move(mappedFile)) {
+    parse({ reinterpret_cast<const char*>(file->data()), file->size() });
+}
+
+SignatureDatabase SignatureDatabase::open(const std::filesystem::path& path) {
+    return SignatureDatabase(MappedFile(path));
+}
+
+void SignatureDatabase::parse(std::string_view text) {
+    // Pattern strings take at least 2 characters per byte, the arena rarely needs to grow
+    records.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+    arena.reserve(text.size());
+
+    std::vector<uint8_t> value, mask; // Reused for all signatures
+    size_t lineNumber = 0;
+    for(size_t pos = 0; pos < text.size();) {
+        auto end = text.find('\n', pos);
+        if(end == std::string_view::npos)
+            end = text.size();
+
+        const auto line = trim(text.substr(pos, end - pos));
+        pos             = end + 1;
+        ++lineNumber;
+
+        if(line.empty() || line.front() == '#')
+            continue;
+
+        Fields fields;
+        const bool parsed = line.front() == '{' ? parseJsonLine(line, fields) : parseTextLine(line, fields);
+        if(!parsed || fields.name.empty()) {
+            malformed.push_back(lineNumber);
+            continue;
+        }
+
+        auto onCapture = [&](const detail::CaptureMarker& marker, size_t offset) { captures.push_back({ marker, offset }); };
+
+        const auto firstCapture = captures.size();
+        const auto size         = decodePattern(fields.pattern, value, mask, onCapture);
+        if(!size) {
+            malformed.push_back(lineNumber);
+            continue;
+        }
+
+        const auto offset = arena.size();
+        arena.insert(arena.end(), value.begin(), value.begin() + *size);
+        arena.insert(arena.end(), mask.begin(), mask.begin() + *size);
+        records.push_back({ fields.name,
+                            fields.pattern,
+                            fields.section,
+                            fields.module,
+                            offset,
+                            *size,
+                            firstCapture,
+                            captures.size() - firstCapture });
+    }
+
+    byName.resize(records.size());
+    for(uint32_t i = 0; i < byName.size(); ++i)
+        byName[i] = i;
+    std::stable_sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return records[a].name < records[b].name; });
+}
+
+SignatureDatabase::Signature SignatureDatabase::operator[](size_t index) const noexcept {
+    const auto& record = records[index];
+    const auto bytes   = std::span(arena).subspan(record.offset, 2 * record.size);
+    return { record.name, record.source, record.section, record.module, bytes.first(record.size), bytes.last(record.size) };
+}
+
+std::optional<size_t> SignatureDatabase::find(std::string_view name) const noexcept {
+    const auto it = std::lower_bound(byName.begin(), byName.end(), name, [&](uint32_t index, std::string_view key) {
+        return records[index].name < key;
+    });
+    if(it == byName.end() || records[*it].name != name)
+        return std::nullopt;
+    return *it;
+}
+
+std::optional<AOBPattern> SignatureDatabase::pattern(size_t index) const {
+    const auto& record = records[index];
+    const auto bytes   = std::span(arena).subspan(record.offset, 2 * record.size);
+
+    std::vector<AOBPattern::Capture> patternCaptures;
+    patternCaptures.reserve(record.captureCount);
+    for(const auto& [marker, offset] : std::span(captures).subspan(record.firstCapture, record.captureCount))
+        patternCaptures.push_back({ std::string(marker.name), marker.kind, offset, marker.size, marker.trailing });
+
+    return AOBPattern::fromBytes(bytes.first(record.size), bytes.last(record.size), std::move(patternCaptures));
+}
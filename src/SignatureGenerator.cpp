@@ -0,0 +1,256 @@
+#include "SignatureGenerator.h"
+#include "ScanKernels.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include "ImageView.h"
+#ifdef B3L_HAVE_ASSEMBLERS
+    #include "Disassembler.h"
+#endif
+
+using namespace B3L;
+
+namespace {
+
+    constexpr size_t gramSize = 4;
+
+    uint32_t loadGram(const uint8_t* data) noexcept {
+        uint32_t gram;
+        std::memcpy(&gram, data, sizeof(gram));
+        return gram;
+    }
+
+    uint32_t bucketOf(uint32_t gram, unsigned bits) noexcept {
+        return (gram * 0x9E3779B1u) >> (32 - bits);
+    }
+
+#ifdef B3L_HAVE_ASSEMBLERS
+    // Clears the mask of operand bytes that differ between builds: relative branch targets and RIP relative
+    // displacements. Fields are located through the encoding info of the Disassembler.
+    void wildcardOperands(const Instruction& instruction, uint8_t* mask) {
+        const auto& encoding = instruction.encoding;
+
+        const auto& groups        = instruction.groups;
+        const bool relativeBranch = std::find(groups.begin(), groups.end(), CS_GRP_BRANCH_RELATIVE) != groups.end();
+        if(relativeBranch && encoding.imm_size)
+            std::fill_n(mask + encoding.imm_offset, encoding.imm_size, 0);
+
+        const auto& operands   = instruction.operands;
+        const bool ripRelative = std::any_of(operands.begin(), operands.end(), [](const cs_x86_op& op) {
+            return op.type == X86_OP_MEM && op.mem.base == X86_REG_RIP;
+        });
+        if(ripRelative && encoding.disp_size)
+            std::fill_n(mask + encoding.disp_offset, encoding.disp_size, 0);
+    }
+#endif
+
+} // namespace
+
+SignatureGenerator::SignatureGenerator(std::vector<Region> regions,
+                                       std::vector<Relocation> relocations,
+                                       bool is64Bit,
+                                       size_t maxLength)
+: regions(std::move(regions)), relocations(std::move(relocations)), _is64Bit(is64Bit), _maxLength(maxLength) {
+    std::sort(this->relocations.begin(), this->relocations.end(), [](const Relocation& a, const Relocation& b) {
+        return a.address < b.address;
+    });
+
+    size_t total = 0;
+    for(const auto& region : this->regions) {
+        regionStarts.push_back(total);
+        total += region.data.size();
+    }
+    if(total > UINT32_MAX)
+        throw std::length_error("Regions too large to index");
+
+    buildIndex();
+}
+
+void SignatureGenerator::buildIndex() {
+    const auto total = regionStarts.empty() ? 0 : regionStarts.back() + regions.back().data.size();
+    bucketBits       = std::clamp(static_cast<unsigned>(std::bit_width(total)), 8u, 24u) - 1;
+
+    // Counting sort of all 4-gram positions by bucket
+    offsets.assign((size_t{ 1 } << bucketBits) + 1, 0);
+    for(const auto& region : regions) {
+        const auto data = region.data.data();
+        for(size_t i = 0; i + gramSize <= region.data.size(); ++i)
+            ++offsets[bucketOf(loadGram(data + i), bucketBits) + 1];
+    }
+
+    for(size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+
+    auto cursor = offsets;
+    positions.resize(offsets.back());
+    for(size_t r = 0; r < regions.size(); ++r) {
+        const auto data = regions[r].data.data();
+        for(size_t i = 0; i + gramSize <= regions[r].data.size(); ++i)
+            positions[cursor[bucketOf(loadGram(data + i), bucketBits)]++] = static_cast<uint32_t>(regionStarts[r] + i);
+    }
+}
+
+std::optional<SignatureGenerator::Location> SignatureGenerator::locateAddress(uint64_t address) const noexcept {
+    for(size_t r = 0; r < regions.size(); ++r) {
+        if(address >= regions[r].address && address - regions[r].address < regions[r].data.size())
+            return Location{ r, static_cast<size_t>(address - regions[r].address) };
+    }
+    return std::nullopt;
+}
+
+SignatureGenerator::Location SignatureGenerator::locatePosition(size_t position) const noexcept {
+    const auto region = std::upper_bound(regionStarts.begin(), regionStarts.end(), position) - regionStarts.begin() - 1;
+    return { static_cast<size_t>(region), position - regionStarts[region] };
+}
+
+std::vector<SignatureGenerator::Location>
+SignatureGenerator::seedCandidates(std::span<const uint8_t> value, std::span<const uint8_t> mask, size_t& length) const {
+    std::vector<Location> candidates;
+
+    size_t run = 0;
+    for(length = 0; length < value.size() && run < gramSize; ++length)
+        run = mask[length] == 0xFF ? run + 1 : 0;
+
+    auto matches = [&](const Location& location) {
+        const auto& data = regions[location.region].data;
+        return location.offset + length <= data.size() &&
+               detail::matchesAt(data.data() + location.offset, value.data(), mask.data(), length);
+    };
+
+    if(run == gramSize) {
+        const auto gramOffset = length - gramSize;
+        const auto gram       = loadGram(value.data() + gramOffset);
+        const auto bucket     = bucketOf(gram, bucketBits);
+
+        for(auto i = offsets[bucket]; i < offsets[bucket + 1]; ++i) {
+            const auto location = locatePosition(positions[i]);
+            if(location.offset < gramOffset)
+                continue;
+
+            const Location candidate{ location.region, location.offset - gramOffset };
+            if(matches(candidate))
+                candidates.push_back(candidate);
+        }
+        return candidates;
+    }
+
+    // No exact run to look up, fall back to scanning for the whole pattern
+    const auto pattern = AOBPattern::fromBytes(value, mask);
+    if(!pattern)
+        return candidates;
+
+    for(size_t r = 0; r < regions.size(); ++r) {
+        const auto begin = regions[r].data.data();
+        const auto end   = begin + regions[r].data.size();
+        for(auto hit = begin; (hit = detail::findPattern(hit, end, *pattern)) != end; ++hit)
+            candidates.push_back({ r, static_cast<size_t>(hit - begin) });
+    }
+    return candidates;
+}
+
+std::optional<AOBPattern>
+SignatureGenerator::shortestUnique(uint64_t address, std::span<const uint8_t> value, std::span<const uint8_t> mask) const {
+    const auto target = locateAddress(address);
+    if(!target || value.size() != mask.size())
+        return std::nullopt;
+
+    const auto& targetData = regions[target->region].data;
+    const auto size        = (std::min)({ value.size(), _maxLength, targetData.size() - target->offset });
+    if(size == 0 || !detail::matchesAt(targetData.data() + target->offset, value.data(), mask.data(), size))
+        return std::nullopt;
+
+    value = value.first(size);
+    mask  = mask.first(size);
+
+    size_t length   = 0;
+    auto candidates = seedCandidates(value, mask, length);
+
+    // The target itself always remains a candidate
+    while(candidates.size() > 1 && length < size) {
+        const auto next = length++;
+
+        std::erase_if(candidates, [&](const Location& location) {
+            const auto& data = regions[location.region].data;
+            if(location.offset + length > data.size())
+                return true;
+            return (data[location.offset + next] & mask[next]) != value[next];
+        });
+    }
+
+    if(candidates.size() != 1)
+        return std::nullopt;
+
+    return AOBPattern::fromBytes(value.first(length), mask.first(length));
+}
+
+#ifdef B3L_HAVE_ASSEMBLERS
+std::optional<AOBPattern> SignatureGenerator::generate(uint64_t address) const {
+    const auto location = locateAddress(address);
+    if(!location)
+        return std::nullopt;
+
+    const auto& data     = regions[location->region].data;
+    const auto code      = data.data() + location->offset;
+    const auto available = (std::min)(data.size() - location->offset, _maxLength);
+
+    std::vector<uint8_t> value(code, code + available);
+    std::vector<uint8_t> mask(available, 0xFF);
+
+    // Decode whole instructions, trailing bytes that don't form one are dropped
+    const uint8_t* cursor = code;
+    size_t remaining      = available;
+    auto current          = static_cast<uintptr_t>(address);
+    while(true) {
+        const auto instruction = _is64Bit ? Disassembler<DisassemblerMode::x64>::disassemble(&cursor, remaining, current)
+                                         : Disassembler<DisassemblerMode::x86>::disassemble(&cursor, remaining, current);
+        if(!instruction)
+            break;
+
+        wildcardOperands(*instruction, mask.data() + (instruction->address - address));
+    }
+
+    const auto decoded = static_cast<size_t>(cursor - code);
+    value.resize(decoded);
+    mask.resize(decoded);
+
+    // Relocated fields may start before address
+    const auto first = address > sizeof(uint64_t) ? address - sizeof(uint64_t) : 0;
+    auto it          = std::lower_bound(relocations.begin(), relocations.end(), first, [](const Relocation& r, uint64_t a) {
+        return r.address < a;
+    });
+    for(; it != relocations.end() && it->address < address + decoded; ++it) {
+        for(uint64_t byte = it->address; byte < it->address + it->size; ++byte) {
+            if(byte >= address && byte < address + decoded)
+                mask[byte - address] = 0;
+        }
+    }
+
+    for(size_t i = 0; i < decoded; ++i)
+        value[i] &= mask[i];
+
+    return shortestUnique(address, value, mask);
+}
+#endif
+
+SignatureGenerator SignatureGenerator::fromImage(const ImageView& image, const SectionFilter& filter, size_t maxLength) {
+    std::vector<Region> regions;
+    for(auto index : filter.select(image)) {
+        const auto header = image.section(index);
+        regions.push_back({ image.baseAddress() + header->VirtualAddress, image.sectionData(index) });
+    }
+
+    std::vector<Relocation> relocations;
+    for(auto block = image.relocationsBegin(); block != image.relocationsEnd(); ++block) {
+        for(auto entry : block->entries()) {
+            const auto type    = ImageView::RelocationBlock::type(entry);
+            const auto address = image.baseAddress() + block->pageRVA() + ImageView::RelocationBlock::offset(entry);
+            if(type == PE::RelocationType::HighLow)
+                relocations.push_back({ address, 4 });
+            else if(type == PE::RelocationType::Dir64)
+                relocations.push_back({ address, 8 });
+        }
+    }
+
+    return SignatureGenerator(std::move(regions), std::move(relocations), sizeof(void*) == 8, maxLength);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+    #define B3L_HAVE_SSE2 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+// Functions using AVX2 intrinsics have to be tagged on gcc and clang since the translation unit isn't built with -mavx2.
+#if defined(__clang__) || defined(__GNUC__)
+    #define B3L_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define B3L_TARGET_AVX2
+#endif
+
+namespace B3L::detail {
+
+    // Returns whether the executing CPU and OS support AVX2. Result is cached after the first call.
+    [[nodiscard]] inline bool cpuSupportsAvx2() noexcept {
+#if defined(B3L_HAVE_SSE2)
+        static const bool supported = [] {
+    #if defined(_MSC_VER)
+            int info[4]{};
+            __cpuid(info, 0);
+            if(info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            if(!osxsave || !avx)
+                return false;
+
+            // OS has to preserve XMM and YMM state on context switches
+            if((_xgetbv(0) & 0x6) != 0x6)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            return __builtin_cpu_supports("avx2") != 0;
+    #endif
+        }();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+} // namespace B3L::detail
@@ -0,0 +1,43 @@
+#include "StreamingScanner.h"
+#include <algorithm>
+
+using namespace B3L;
+
+StreamingScanner::StreamingScanner(AOBPattern needle) : needle(std::move(needle)) {
+    carry.reserve(this->needle.size() - 1);
+    boundary.reserve(2 * (this->needle.size() - 1));
+}
+
+std::vector<uint64_t> StreamingScanner::feed(std::span<const uint8_t> chunk) {
+    std::vector<uint64_t> matches;
+    feed(chunk, [&matches](uint64_t offset) { matches.push_back(offset); });
+    return matches;
+}
+
+void StreamingScanner::reset() noexcept {
+    carry.clear();
+    boundary.clear();
+    consumed = 0;
+}
+
+uint64_t StreamingScanner::position() const noexcept {
+    return consumed;
+}
+
+const AOBPattern& StreamingScanner::pattern() const noexcept {
+    return needle;
+}
+
+void StreamingScanner::updateCarry(std::span<const uint8_t> chunk) {
+    const auto keep = needle.size() - 1;
+
+    if(chunk.size() >= keep) {
+        carry.assign(chunk.end() - keep, chunk.end());
+        return;
+    }
+
+    // Chunk is shorter than the carry, keep the tail of the previous carry followed by the whole chunk
+    carry.insert(carry.end(), chunk.begin(), chunk.end());
+    if(carry.size() > keep)
+        carry.erase(carry.begin(), carry.end() - keep);
+}
@@ -1,4 +1,6 @@
 #include "StringUtil.h"
+#include <cstring>
+#include <cwctype>
 
 void B3L::StringUtil::replace(std::string& str, const std::string& old_value, const std::string& new_value) {
     if(str.empty() || old_value.empty())
@@ -0,0 +1,119 @@
+#include "B3L/AOBScanner.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+namespace {
+    // Offsets of the begin and end of every match.
+    std::vector<std::pair<size_t, size_t>> offsets(const std::vector<AOBRegex::Match>& matches, const uint8_t* base) {
+        std::vector<std::pair<size_t, size_t>> result;
+        for(const auto& match : matches)
+            result.emplace_back(match.begin - base, match.end - base);
+        return result;
+    }
+} // namespace
+
+TEST(AOBRegexTests, FromString) {
+    // Good
+    EXPECT_TRUE(AOBRegex::fromString("48 8B ?? 4? 8B/F8"));
+    EXPECT_TRUE(AOBRegex::fromString("(E8|E9) ?? ?? ?? ??"));
+    EXPECT_TRUE(AOBRegex::fromString("(48 8B|4C (89|8B)) [40-4F 50]"));
+    EXPECT_TRUE(AOBRegex::fromString("[^00 CC] {2,6} C3"));
+    EXPECT_TRUE(AOBRegex::fromString("E8 {4} (90|)"));
+
+    // Bad
+    EXPECT_FALSE(AOBRegex::fromString(""));            // Matches the empty string
+    EXPECT_FALSE(AOBRegex::fromString("{0,4}"));       // Matches the empty string
+    EXPECT_FALSE(AOBRegex::fromString("(E8|E9"));      // Unterminated group
+    EXPECT_FALSE(AOBRegex::fromString("E8|E9)"));      // Unbalanced group
+    EXPECT_FALSE(AOBRegex::fromString("[40-4F"));      // Unterminated class
+    EXPECT_FALSE(AOBRegex::fromString("[4F-40]"));     // Empty range
+    EXPECT_FALSE(AOBRegex::fromString("[4?-50]"));     // Inexact range bound
+    EXPECT_FALSE(AOBRegex::fromString("E8 {6,2}"));    // Empty gap
+    EXPECT_FALSE(AOBRegex::fromString("E8 {1,65}"));   // Too many positions
+    EXPECT_FALSE(AOBRegex::fromString("E8 {60} {8}")); // Too many positions
+}
+
+TEST(AOBRegexTests, Find) {
+    std::vector<uint8_t> haystack{ 0xCC, 0xE9, 0x10, 0x00, 0x00, 0x00, 0x41, 0x8B, 0x90, 0x90, 0x90, 0xC3, 0x4C, 0x89 };
+
+    auto jump = AOBRegex::fromString("(E8|E9) ?? ?? ?? ?? [40-4F] 8B").value();
+    auto match = jump.find(haystack);
+    ASSERT_TRUE(match);
+    EXPECT_EQ(match->begin, haystack.data() + 1);
+    EXPECT_EQ(match->end, haystack.data() + 8);
+
+    // Earliest end, begins as early as possible
+    auto gap = AOBRegex::fromString("8B {1,4} C3").value();
+    match    = gap.find(haystack);
+    ASSERT_TRUE(match);
+    EXPECT_EQ(match->begin, haystack.data() + 7);
+    EXPECT_EQ(match->end, haystack.data() + 12);
+
+    EXPECT_FALSE(AOBRegex::fromString("8B {1,2} C3").value().find(haystack));
+    EXPECT_FALSE(AOBRegex::fromString("[^CC] E9").value().find(haystack));
+
+    auto it = AOBScanner::find(haystack.begin(), haystack.end(), AOBRegex::fromString("(48|4C) (89|8B)").value());
+    EXPECT_EQ(std::distance(haystack.begin(), it), 12);
+}
+
+// Fixed length regexes have to find the same matches as the equivalent AOBPattern.
+TEST(AOBRegexTests, FindAllMatchesAOBPattern) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(4096);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03", "?? 03 ?? 01", "02", "03 ?? 03 ?? 03", "0? 02/FE" }) {
+        auto pattern = AOBPattern::fromString(str).value();
+        auto regex   = AOBRegex::fromString(str).value();
+
+        std::vector<std::pair<size_t, size_t>> expected;
+        for(auto it : AOBScanner::findAll(haystack.begin(), haystack.end(), pattern)) {
+            const auto offset = static_cast<size_t>(it - haystack.begin());
+            expected.emplace_back(offset, offset + pattern.size());
+        }
+
+        EXPECT_EQ(offsets(regex.findAll(haystack), haystack.data()), expected) << str;
+    }
+}
+
+// The DFA and the bit-parallel simulation have to agree.
+TEST(AOBRegexTests, DfaMatchesSimulation) {
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> dist(0, 7);
+
+    std::vector<uint8_t> haystack(8192);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 {0,3} 02", "(01 02|03 {2} 04|05) [06-07]", "[^00] {1,5} (00|01 01) 02", "0? {2,4} 07 07" }) {
+        auto dfa        = AOBRegex::fromString(str).value();
+        auto simulation = AOBRegex::fromString(str, 0).value();
+        EXPECT_TRUE(dfa.usesDfa()) << str;
+        EXPECT_FALSE(simulation.usesDfa());
+
+        auto matches = dfa.findAll(haystack);
+        EXPECT_FALSE(matches.empty()) << str;
+        EXPECT_EQ(offsets(matches, haystack.data()), offsets(simulation.findAll(haystack), haystack.data())) << str;
+    }
+
+    // Every combination of active gap positions is a DFA state, too many for the default limit
+    auto large = AOBRegex::fromString("[00-03] {1,12} 07").value();
+    EXPECT_FALSE(large.usesDfa());
+    EXPECT_FALSE(large.findAll(haystack).empty());
+
+    // Limits beyond 16 bit state ids are clamped rather than wrapping around
+    for(const auto& str : { "[00-03] {1,12} 07", "[00-03] {1,18} 07" }) {
+        auto unlimited = AOBRegex::fromString(str, size_t{ 1 } << 20).value();
+        auto matches   = unlimited.findAll(haystack);
+        EXPECT_FALSE(matches.empty()) << str;
+        EXPECT_EQ(offsets(matches, haystack.data()),
+                  offsets(AOBRegex::fromString(str, 0).value().findAll(haystack), haystack.data()))
+        << str;
+    }
+    EXPECT_TRUE(AOBRegex::fromString("[00-03] {1,12} 07", size_t{ 1 } << 20)->usesDfa());
+}
@@ -1,20 +1,101 @@
 #include "B3L/AOBScanner.h"
 #include <gtest/gtest.h>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
 
 using namespace B3L;
 
+namespace {
+    // Needle representation of the std::search based find overload. Only supports exact bytes and full wildcards.
+    std::vector<int16_t> toSearchNeedle(const AOBPattern& pattern) {
+        std::vector<int16_t> needle;
+        for(size_t i = 0; i < pattern.size(); ++i)
+            needle.push_back(pattern.mask()[i] ? pattern.value()[i] : int16_t{ -1 });
+        return needle;
+    }
+} // namespace
+
 TEST(AOBScannerTests, PatternFromString) {
     // Good
     EXPECT_TRUE(AOBPattern::fromString("01 23 45 67 89 AB CD EF ??"));
     EXPECT_TRUE(AOBPattern::fromString("0123456789ABCDEF??"));
     EXPECT_TRUE(AOBPattern::fromString("0123456789abcdef??"));
+    EXPECT_TRUE(AOBPattern::fromString("1? ?2"));          // Nibble wildcards
+    EXPECT_TRUE(AOBPattern::fromString("48 8B/F8 ?? 05")); // Bit mask
 
     // Bad
     EXPECT_FALSE(AOBPattern::fromString(""));          // Empty string is not a valid pattern
     EXPECT_FALSE(AOBPattern::fromString("12 3"));      // Str len not even
-    EXPECT_FALSE(AOBPattern::fromString("1? ?2"));     // Bad wildcard offset
     EXPECT_FALSE(AOBPattern::fromString("12 3H"));     // Bad symbol
     EXPECT_FALSE(AOBPattern::fromString("0x11 0x32")); // 0x syntax not supported
+    EXPECT_FALSE(AOBPattern::fromString("8B/F"));      // Incomplete mask
+    EXPECT_FALSE(AOBPattern::fromString("8?/F0"));     // Mask on wildcard
+    EXPECT_FALSE(AOBPattern::fromString("/F0"));       // Mask without value
+}
+
+TEST(AOBScannerTests, PatternMasks) {
+    auto pattern = AOBPattern::fromString("4? ?B 8B/F8 ??").value();
+
+    EXPECT_EQ(std::vector<uint8_t>(pattern.value().begin(), pattern.value().end()),
+              (std::vector<uint8_t>{ 0x40, 0x0B, 0x88, 0x00 }));
+    EXPECT_EQ(std::vector<uint8_t>(pattern.mask().begin(), pattern.mask().end()),
+              (std::vector<uint8_t>{ 0xF0, 0x0F, 0xF8, 0x00 }));
+
+    const uint8_t match[]{ 0x48, 0x8B, 0x8C, 0x12 };
+    const uint8_t mismatch[]{ 0x48, 0x8B, 0x90, 0x12 };
+    EXPECT_TRUE(pattern.matchesAt(match));
+    EXPECT_FALSE(pattern.matchesAt(mismatch));
+
+    static_assert("4? ?B 8B/F8 ??"_aob.value[2] == 0x88);
+    static_assert("4? ?B 8B/F8 ??"_aob.mask[0] == 0xF0);
+}
+
+TEST(AOBScannerTests, PatternCaptures) {
+    auto pattern = AOBPattern::fromString("48 8B 05 <global:rel4> 83 3D <flag:rel4+1> 00 <raw1>").value();
+    EXPECT_EQ(pattern.size(), 15u);
+    EXPECT_EQ(pattern.mask()[3], 0x00);
+    ASSERT_EQ(pattern.captures().size(), 3u);
+
+    auto flag = pattern.capture("flag");
+    ASSERT_TRUE(flag);
+    EXPECT_EQ(flag->kind, CaptureKind::Relative);
+    EXPECT_EQ(flag->offset, 9u);
+    EXPECT_EQ(flag->size, 4);
+    EXPECT_EQ(flag->trailing, 1);
+    EXPECT_EQ(pattern.captures()[2].name, "");
+    EXPECT_FALSE(pattern.capture("missing"));
+
+    static_assert("E8 <target:rel4>"_aob.size() == 5);
+
+    EXPECT_FALSE(AOBPattern::fromString("E8 <rel3>"));         // Bad size
+    EXPECT_FALSE(AOBPattern::fromString("E8 <ptr:abs8+1>"));   // Trailing bytes on absolute field
+    EXPECT_FALSE(AOBPattern::fromString("E8 <a b:rel4>"));     // Bad name
+    EXPECT_FALSE(AOBPattern::fromString("E8 <rel4"));          // Unterminated
+    EXPECT_FALSE(AOBPattern::fromString("<x:rel4> <x:rel4>")); // Duplicate name
+}
+
+TEST(AOBScannerTests, ResolveCaptures) {
+    // call -0x10; mov rax, [rip+0x20]; cmp dword ptr [rip+0x30], 0; mov rax, [rcx-8]; mov rax, [abs64]
+    std::vector<uint8_t> code{ 0xE8, 0xF0, 0xFF, 0xFF, 0xFF, 0x48, 0x8B, 0x05, 0x20, 0x00, 0x00, 0x00,
+                               0x83, 0x3D, 0x30, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8B, 0x41, 0xF8, 0x48,
+                               0xA1, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
+
+    auto pattern = AOBPattern::fromString("E8 <call:rel4> 48 8B 05 <global:rel4> 83 3D <flag:rel4+1> 00 "
+                                          "48 8B 41 <offset:raw1> 48 A1 <pointer:abs8>")
+                       .value();
+    ASSERT_TRUE(pattern.matchesAt(code.data()));
+
+    constexpr uint64_t address = 0x1000;
+    EXPECT_EQ(pattern.capture("call")->resolve(code.data(), address), 0x1005u - 0x10);
+    EXPECT_EQ(pattern.capture("global")->resolve(code.data(), address), 0x100Cu + 0x20);
+    EXPECT_EQ(pattern.capture("flag")->resolve(code.data(), address), 0x1013u + 0x30);
+    EXPECT_EQ(pattern.capture("offset")->resolve(code.data(), address), static_cast<uint64_t>(-8));
+    EXPECT_EQ(pattern.capture("pointer")->resolve(code.data(), address), 0x1122334455667788u);
+
+    EXPECT_EQ(pattern.resolve(code.data(), address), 0x0FF5u);
+    EXPECT_EQ(AOBPattern::fromString("E8").value().resolve(code.data(), address), address);
 }
 
 TEST(AOBScannerTests, Find) {
@@ -27,3 +108,236 @@ TEST(AOBScannerTests, Find) {
 
     EXPECT_EQ(offset, 5);
 }
+
+// Contiguous ranges are routed to the anchor kernel and have to produce the same results as the std::search path.
+TEST(AOBScannerTests, FindContiguousMatchesSearch) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(4096);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03", "?? 03 ?? 01", "00", "03 03 03 03 03 03", "?? ??", "02 ?? ?? ?? ?? 01" }) {
+        auto needle       = AOBPattern::fromString(str).value();
+        auto searchNeedle = toSearchNeedle(needle);
+
+        for(size_t offset = 0; offset < 64; ++offset) {
+            auto begin = haystack.begin() + offset;
+
+            auto expected = AOBScanner::find(begin, haystack.end(), searchNeedle.begin(), searchNeedle.end());
+            auto actual   = AOBScanner::find(begin, haystack.end(), needle);
+            EXPECT_EQ(expected, actual) << str;
+
+            // Matches that end exactly at the end of the haystack
+            auto tail = haystack.end() - offset;
+            EXPECT_EQ(AOBScanner::find(begin, tail, searchNeedle.begin(), searchNeedle.end()),
+                      AOBScanner::find(begin, tail, needle))
+            << str;
+        }
+    }
+}
+
+TEST(AOBScannerTests, FindParallel) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> dist(0, 7);
+
+    std::vector<uint8_t> haystack(64 * 1024);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03 04", "?? 07 ?? 07 06", "05 05 05 05 05 05", "01 02 03 04 05 06 07 00" }) {
+        auto needle = AOBPattern::fromString(str).value();
+
+        std::vector<const uint8_t*> expected;
+        auto it = haystack.begin();
+        while((it = AOBScanner::find(it, haystack.end(), needle)) != haystack.end()) {
+            expected.push_back(std::to_address(it));
+            ++it;
+        }
+
+        // Small chunks to exercise matches straddling chunk boundaries
+        for(size_t chunkSize : { 1, 7, 4096, 0 }) {
+            auto first = AOBScanner::findParallel(haystack, needle, 4, chunkSize);
+            EXPECT_EQ(first, expected.empty() ? haystack.data() + haystack.size() : expected.front()) << str;
+
+            EXPECT_EQ(AOBScanner::findAllParallel(haystack, needle, 4, chunkSize), expected) << str;
+        }
+    }
+}
+
+TEST(AOBScannerTests, FindApproximate) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<uint8_t> haystack(64 * 1024);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    auto pattern = AOBPattern::fromString("48 8B 05 ?? ?? ?? ?? 48 85 C0 74 ?? 48 8B 4? 10").value();
+    const uint8_t exact[]{ 0x48, 0x8B, 0x05, 1, 2, 3, 4, 0x48, 0x85, 0xC0, 0x74, 5, 0x48, 0x8B, 0x41, 0x10 };
+
+    // Exact copy, one and two changed bytes, changed wildcards don't count
+    std::copy(std::begin(exact), std::end(exact), haystack.begin() + 30000);
+    std::copy(std::begin(exact), std::end(exact), haystack.begin() + 20000);
+    std::copy(std::begin(exact), std::end(exact), haystack.begin() + 10000);
+    haystack[20000 + 8]  = 0x89;
+    haystack[20000 + 4]  = 0xFF;
+    haystack[10000 + 1]  = 0x89;
+    haystack[10000 + 14] = 0x51;
+
+    auto matches = AOBScanner::findApproximate(haystack, pattern, 2);
+    std::vector<ApproximateMatch> expected{ { haystack.data() + 30000, 0 },
+                                            { haystack.data() + 20000, 1 },
+                                            { haystack.data() + 10000, 2 } };
+    EXPECT_EQ(matches, expected);
+
+    matches = AOBScanner::findApproximate(haystack, pattern, 1);
+    expected.pop_back();
+    EXPECT_EQ(matches, expected);
+}
+
+// Pigeonhole filtered and exhaustive paths have to agree with a plain count at every position.
+TEST(AOBScannerTests, FindApproximateMatchesCount) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(4096);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03 ?? 00 01 02 03", "0? 02/FE 03 01 ?? ?? 02 00 01 03 02 01 00 01 02 03 00 03", "02" }) {
+        auto pattern = AOBPattern::fromString(str).value();
+
+        for(size_t k : { 0, 1, 2, 5 }) {
+            std::vector<ApproximateMatch> expected;
+            for(size_t pos = 0; pos + pattern.size() <= haystack.size(); ++pos) {
+                size_t mismatches = 0;
+                for(size_t i = 0; i < pattern.size(); ++i)
+                    mismatches += (haystack[pos + i] & pattern.mask()[i]) != pattern.value()[i];
+                if(mismatches <= k)
+                    expected.push_back({ haystack.data() + pos, mismatches });
+            }
+            std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+                return a.mismatches < b.mismatches;
+            });
+
+            EXPECT_EQ(AOBScanner::findApproximate(haystack, pattern, k), expected) << str << " k=" << k;
+        }
+    }
+}
+
+TEST(AOBScannerTests, FindAll) {
+    std::vector<uint8_t> haystack{ 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0x01, 0xAA, 0xAA };
+    auto needle = AOBPattern::fromString("AA AA").value();
+
+    auto offsets = [&](const std::vector<std::vector<uint8_t>::iterator>& matches) {
+        std::vector<ptrdiff_t> result;
+        for(auto it : matches)
+            result.push_back(std::distance(haystack.begin(), it));
+        return result;
+    };
+
+    auto overlapping = AOBScanner::findAll(haystack.begin(), haystack.end(), needle);
+    EXPECT_EQ(offsets(overlapping), (std::vector<ptrdiff_t>{ 0, 1, 2, 3, 6 }));
+
+    auto nonOverlapping = AOBScanner::findAll(haystack.begin(), haystack.end(), needle, MatchMode::NonOverlapping);
+    EXPECT_EQ(offsets(nonOverlapping), (std::vector<ptrdiff_t>{ 0, 2, 6 }));
+}
+
+TEST(AOBScannerTests, MatchRange) {
+    const std::vector<uint8_t> haystack{ 0xE8, 0x01, 0xE8, 0x02, 0x90, 0xE8, 0x03 };
+    auto needle = AOBPattern::fromString("E8 ??").value();
+
+    auto range = AOBScanner::matches(haystack.begin(), haystack.end(), needle);
+    static_assert(std::ranges::forward_range<decltype(range)>);
+    static_assert(std::ranges::view<decltype(range)>);
+
+    auto operands = range | std::views::transform([](auto it) { return *std::next(it); }) | std::views::take(2);
+
+    std::vector<uint8_t> result;
+    std::ranges::copy(operands, std::back_inserter(result));
+    EXPECT_EQ(result, (std::vector<uint8_t>{ 0x01, 0x02 }));
+
+    EXPECT_EQ(std::ranges::distance(range), 3);
+}
+
+TEST(AOBScannerTests, StaticPattern) {
+    constexpr auto pattern = "ED ?? FF 48 89"_aob;
+    static_assert(pattern.size() == 5);
+    static_assert(pattern.value[0] == 0xED && pattern.mask[0] == 0xFF);
+    static_assert(pattern.value[1] == 0x00 && pattern.mask[1] == 0x00);
+    static_assert("0123456789abcdef??"_aob.size() == 9);
+
+    std::vector<uint8_t> haystack{ 0x8B, 0x0C, 0x08, 0xE8, 0x74, 0xED, 0xED, 0xFF, 0x48, 0x89 };
+
+    auto it = AOBScanner::find(haystack.begin(), haystack.end(), pattern);
+    EXPECT_EQ(std::distance(haystack.begin(), it), 5);
+
+    auto specialized = AOBScanner::find<"ED ?? FF 48 89"_aob>(haystack.begin(), haystack.end());
+    EXPECT_EQ(std::distance(haystack.begin(), specialized), 5);
+
+    auto absent = AOBScanner::find<"ED ?? FF 48 88"_aob>(haystack.begin(), haystack.end());
+    EXPECT_EQ(absent, haystack.end());
+}
+
+// Partially masked patterns have to give the same results on the vectorized and the forward iterator path.
+TEST(AOBScannerTests, FindMaskedMatchesForwardIterator) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<uint8_t> haystack(4096);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng) & 0x1F);
+
+    const std::list<uint8_t> list(haystack.begin(), haystack.end());
+
+    for(const auto& str : { "1? 0?", "?1 ?? ?3", "1F/1C 0?", "01/01 02/02 04/04", "0? 1?" }) {
+        auto needle = AOBPattern::fromString(str).value();
+
+        auto expected = AOBScanner::findAll(list.begin(), list.end(), needle);
+        auto actual   = AOBScanner::findAll(haystack.begin(), haystack.end(), needle);
+        ASSERT_EQ(expected.size(), actual.size()) << str;
+
+        for(size_t i = 0; i < actual.size(); ++i)
+            EXPECT_EQ(std::distance(list.begin(), expected[i]), std::distance(haystack.begin(), actual[i])) << str;
+    }
+}
+
+TEST(AOBScannerTests, FindHorspool) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(8192);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03 00 01 02", "?? 03 ?? 01 02 03 00", "0? 01 01 01", "00", "03 ?? 02", "01 02 ??" }) {
+        auto needle = AOBPattern::fromString(str).value();
+
+        for(size_t offset = 0; offset < 32; ++offset) {
+            auto begin = haystack.begin() + offset;
+
+            auto expected = AOBScanner::find(begin, haystack.end(), needle, ScanStrategy::Anchor);
+            auto actual   = AOBScanner::find(begin, haystack.end(), needle, ScanStrategy::Horspool);
+            EXPECT_EQ(expected, actual) << str;
+        }
+    }
+    // Long patterns planted in different lanes of the interleaved scan
+    std::vector<uint8_t> value(24), mask(24, 0xFF);
+    std::iota(value.begin(), value.end(), uint8_t{ 0x10 });
+    const auto needle = AOBPattern::fromBytes(value, mask).value();
+
+    std::vector<uint8_t> planted(64 * 1024);
+    for(auto& b : planted)
+        b = static_cast<uint8_t>(dist(rng));
+    for(size_t offset : { size_t{ 9000 }, size_t{ 9100 }, size_t{ 30000 }, size_t{ 50001 }, planted.size() - 24 })
+        std::copy(value.begin(), value.end(), planted.begin() + offset);
+
+    for(size_t offset : { 0, 9001, 9101, 40000, 50002 }) {
+        auto begin = planted.begin() + offset;
+        EXPECT_EQ(AOBScanner::find(begin, planted.end(), needle, ScanStrategy::Anchor),
+                  AOBScanner::find(begin, planted.end(), needle, ScanStrategy::Horspool))
+        << offset;
+    }
+}
@@ -0,0 +1,85 @@
+#include "B3L/CompiledPattern.h"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+
+using namespace B3L;
+
+TEST(CompiledPatternTests, ByteFrequencyTable) {
+    const auto& x64 = ByteFrequencyTable::x86_64();
+    EXPECT_GT(x64.matchProbability(0x48), x64.matchProbability(0xD6));
+    EXPECT_GT(x64.matchProbability(0x00), x64.matchProbability(0x0F));
+    EXPECT_DOUBLE_EQ(x64.matchProbability(0x00, 0x00), 1.0);
+    EXPECT_NEAR(x64.matchProbability(0x40, 0xF0), [&] {
+        double sum = 0;
+        for(int b = 0x40; b <= 0x4F; ++b)
+            sum += x64.matchProbability(static_cast<uint8_t>(b));
+        return sum;
+    }(), 1e-12);
+
+    const uint8_t sample[] = { 1, 1, 1, 2 };
+    auto learned           = ByteFrequencyTable::fromSample(sample);
+    EXPECT_GT(learned.matchProbability(1), learned.matchProbability(2));
+    EXPECT_GT(learned.matchProbability(2), learned.matchProbability(3));
+
+    // Unseen bytes keep a non zero probability
+    EXPECT_GT(learned.matchProbability(3), 0.0);
+}
+
+TEST(CompiledPatternTests, SelectStrategy) {
+    // Rare anchor bytes, the anchor compare rarely produces candidates
+    auto call = CompiledPattern::compile(AOBPattern::fromString("48 89 5C 24 ?? E8 ?? ?? ?? ??").value());
+    EXPECT_EQ(call.strategy(), ScanStrategy::Anchor);
+    EXPECT_EQ(call.pattern().value()[call.primaryAnchor()], 0x5C);
+
+    // Long exact suffix of uncommon bytes allows large shifts
+    std::vector<uint8_t> value(128), mask(128, 0xFF);
+    std::iota(value.begin(), value.end(), uint8_t{ 0x90 });
+    auto solid = CompiledPattern::compile(AOBPattern::fromBytes(value, mask).value());
+    EXPECT_EQ(solid.strategy(), ScanStrategy::Horspool);
+    EXPECT_EQ(solid.skipTable()[0x90], 127);
+    EXPECT_EQ(solid.skipTable()[0x10], 128);
+
+    // Shorter exact patterns are faster with the anchor compare
+    value.resize(24);
+    mask.resize(24);
+    auto shortSolid = CompiledPattern::compile(AOBPattern::fromBytes(value, mask).value());
+    EXPECT_EQ(shortSolid.strategy(), ScanStrategy::Anchor);
+
+    // Horspool needs an exact last byte
+    auto wildcardTail = CompiledPattern::compile(AOBPattern::fromString("01 02 03 04 05 06 07 08 ??").value(),
+                                                 ByteFrequencyTable::x86_64(), ScanStrategy::Horspool);
+    EXPECT_EQ(wildcardTail.strategy(), ScanStrategy::Anchor);
+
+    // Anchors follow the table, 0x01 is rare in a sample dominated by 0x02
+    const uint8_t sample[] = { 2, 2, 2, 2, 3, 3 };
+    auto learned           = CompiledPattern::compile(AOBPattern::fromString("02 03 01").value(), ByteFrequencyTable::fromSample(sample));
+    EXPECT_EQ(learned.primaryAnchor(), 2);
+    EXPECT_EQ(learned.secondaryAnchor(), 1);
+    EXPECT_LT(learned.matchProbability(), ByteFrequencyTable::fromSample(sample).matchProbability(1));
+}
+
+TEST(CompiledPatternTests, FindMatchesAOBScanner) {
+    std::mt19937 rng(4321);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(8192);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    for(const auto& str : { "01 02 03", "?? 03 ?? 01", "0? 03", "03 03 03 03 03 03", "02 ?? ?? ?? 01 00 01 02 03" }) {
+        SCOPED_TRACE(str);
+        auto needle = AOBPattern::fromString(str).value();
+
+        for(auto strategy : { ScanStrategy::Auto, ScanStrategy::Anchor, ScanStrategy::Horspool }) {
+            auto compiled = CompiledPattern::compile(needle, ByteFrequencyTable::x86_64(), strategy);
+            auto matches  = compiled.findAll(haystack);
+
+            std::vector<const uint8_t*> expected;
+            for(auto it : AOBScanner::findAll(haystack.begin(), haystack.end(), needle))
+                expected.push_back(std::to_address(it));
+
+            EXPECT_EQ(matches, expected);
+        }
+    }
+}
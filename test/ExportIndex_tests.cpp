@@ -0,0 +1,100 @@
+#include "B3L/ExportIndex.h"
+#include "TestImage.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace B3L;
+
+namespace {
+    std::vector<uint8_t> exportingImage() {
+        std::vector<TestImage::Export> exports;
+        for(uint32_t i = 0; i < 100; ++i)
+            exports.push_back({ "Function" + std::to_string(i), 0x1000 + 4 * i, {} });
+        exports.push_back({ "", 0x2000, {} });                          // Ordinal only
+        exports.push_back({});                                          // Unused ordinal
+        exports.push_back({ "HeapAlloc", 0, "NTDLL.RtlAllocateHeap" }); // Forwarded
+
+        TestImage image;
+        image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0xCC) });
+        image.addExportSection("test.dll", 10, exports);
+        return image.buildMapped();
+    }
+} // namespace
+
+TEST(ExportIndexTests, Lookup) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto mapped = exportingImage();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    const ExportIndex index(view);
+    EXPECT_EQ(index.nameCount(), 101u);
+
+    for(uint32_t i = 0; i < 100; ++i) {
+        const auto name   = "Function" + std::to_string(i);
+        const auto result = index.find(name);
+        ASSERT_TRUE(result) << name;
+        EXPECT_EQ(result->name(), name);
+        EXPECT_EQ(result->ordinal(), 10 + i);
+        EXPECT_EQ(result->rva(), 0x1000 + 4 * i);
+    }
+    EXPECT_FALSE(index.find("Function100"));
+    EXPECT_FALSE(index.find(""));
+
+    const auto byHash = index.findByHash(ExportIndex::nameHash("Function42"));
+    ASSERT_TRUE(byHash);
+    EXPECT_EQ(byHash->ordinal(), 52u);
+    EXPECT_FALSE(index.findByHash(ExportIndex::nameHash("Missing")));
+
+    // Ordinals map to names where there is one
+    EXPECT_STREQ(index.findByOrdinal(15)->name(), "Function5");
+    const auto unnamed = index.findByOrdinal(110);
+    ASSERT_TRUE(unnamed);
+    EXPECT_FALSE(unnamed->exportedByName());
+    EXPECT_EQ(unnamed->address(), view.baseAddress() + 0x2000);
+    EXPECT_FALSE(index.findByOrdinal(111));
+    EXPECT_FALSE(index.findByOrdinal(9));
+    EXPECT_FALSE(index.findByOrdinal(113));
+
+    const auto forwarded = index.find("HeapAlloc");
+    ASSERT_TRUE(forwarded);
+    EXPECT_TRUE(forwarded->isForwarded());
+    EXPECT_STREQ(forwarded->forwarder(), "NTDLL.RtlAllocateHeap");
+    EXPECT_EQ(index.findByOrdinal(112), forwarded);
+    EXPECT_EQ(index.find("Function0")->forwarder(), nullptr);
+}
+
+TEST(ExportIndexTests, ConcurrentFirstQuery) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto mapped = exportingImage();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    const ExportIndex index(view);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> found = 0;
+    for(int i = 0; i < 4; ++i)
+        threads.emplace_back([&, i]() { found += index.find("Function" + std::to_string(i)).has_value(); });
+    for(auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(found, 4);
+}
+
+TEST(ExportIndexTests, ImageWithoutExports) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    TestImage image;
+    image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x10, 0xC3) });
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+
+    const ExportIndex index(view);
+    EXPECT_EQ(index.nameCount(), 0u);
+    EXPECT_FALSE(index.find("Function0"));
+    EXPECT_FALSE(index.findByHash(ExportIndex::nameHash("Function0")));
+    EXPECT_FALSE(index.findByOrdinal(1));
+}
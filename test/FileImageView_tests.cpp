@@ -0,0 +1,101 @@
+#include "B3L/FileImageScanner.h"
+#include "B3L/FileImageView.h"
+#include "B3L/MappedFile.h"
+#include "TestImage.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace B3L;
+
+namespace {
+
+    TestImage makeImage() {
+        TestImage image;
+        image.sections.push_back({ ".text", PE::SectionCharacteristics::CntCode | PE::SectionCharacteristics::MemExecute |
+                                            PE::SectionCharacteristics::MemRead,
+                                   { 0x90, 0x48, 0x8B, 0x05, 0x10, 0x20, 0x30, 0x40, 0xC3, 0xCC }, 0 });
+        image.sections.push_back({ ".data", PE::SectionCharacteristics::MemRead | PE::SectionCharacteristics::MemWrite,
+                                   { 0x48, 0x8B, 0x05, 0x00 }, 0x100 });
+        return image;
+    }
+
+} // namespace
+
+TEST(FileImageViewTests, Create) {
+    const auto file = makeImage().build();
+    auto view       = FileImageView::create(file);
+    ASSERT_TRUE(view.has_value());
+
+    EXPECT_TRUE(view->is64Bit());
+    EXPECT_EQ(view->preferredImageBase(), TestImage::imageBase);
+    EXPECT_EQ(view->sectionCount(), 2);
+    EXPECT_EQ(view->sectionName(0), ".text");
+    EXPECT_EQ(view->sectionName(1), ".data");
+    EXPECT_EQ(view->section(2), nullptr);
+    ASSERT_NE(view->dataDirectory(PE::DirectoryEntry::Import), nullptr);
+    EXPECT_EQ(view->dataDirectory(PE::numberOfDirectoryEntries), nullptr);
+
+    // Raw data is limited to the virtual size, file alignment padding is excluded
+    EXPECT_EQ(view->sectionData(0).size(), 10);
+    EXPECT_EQ(view->sectionData(1).size(), 0x100);
+    EXPECT_EQ(view->sectionData(0)[1], 0x48);
+}
+
+TEST(FileImageViewTests, CreateInvalid) {
+    auto file = makeImage().build();
+
+    EXPECT_FALSE(FileImageView::create(std::span(file).first(sizeof(PE::DosHeader) - 1)).has_value());
+
+    // Section raw data outside of the file
+    EXPECT_FALSE(FileImageView::create(std::span(file).first(file.size() - TestImage::fileAlignment)).has_value());
+
+    auto badSignature = file;
+    badSignature[sizeof(PE::DosHeader)] = 0;
+    EXPECT_FALSE(FileImageView::create(badSignature).has_value());
+
+    auto badLfanew = file;
+    badLfanew[offsetof(PE::DosHeader, e_lfanew) + 3] = 0x7F;
+    EXPECT_FALSE(FileImageView::create(badLfanew).has_value());
+}
+
+TEST(FileImageViewTests, TranslateRVA) {
+    const auto file = makeImage().build();
+    auto view       = FileImageView::create(file).value();
+
+    const auto text = view.section(0);
+    EXPECT_EQ(view.RVAtoOffset(text->VirtualAddress + 3), text->PointerToRawData + 3);
+    EXPECT_EQ(view.offsetToRVA(text->PointerToRawData + 3), text->VirtualAddress + 3);
+    EXPECT_EQ(view.RVAtoOffset(0), 0);
+    EXPECT_EQ(*view.RVAtoPointer<const uint8_t*>(text->VirtualAddress + 8), 0xC3);
+
+    // Zero fill and padding between sections are not backed by the file
+    EXPECT_FALSE(view.RVAtoOffset(text->VirtualAddress + 10).has_value());
+    EXPECT_FALSE(view.RVAtoOffset(TestImage::sectionRVA(1) + 0x100).has_value());
+    EXPECT_EQ(view.RVAtoPointer<const uint8_t*>(TestImage::sectionRVA(5)), nullptr);
+}
+
+TEST(FileImageViewTests, ScanMappedFile) {
+    const auto path = std::filesystem::temp_directory_path() / "B3L_FileImageViewTests.bin";
+    {
+        const auto file = makeImage().build();
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+    {
+        MappedFile mapped(path);
+        auto view = FileImageView::create(mapped.bytes());
+        ASSERT_TRUE(view.has_value());
+
+        auto needle = AOBPattern::fromString("48 8B 05").value();
+        EXPECT_EQ(FileImageScanner::find(*view, needle), TestImage::sectionRVA(0) + 1);
+        EXPECT_EQ(FileImageScanner::find(*view, needle, SectionFilter::named(".data")), TestImage::sectionRVA(1));
+
+        const std::vector<uint32_t> expected = { TestImage::sectionRVA(0) + 1, TestImage::sectionRVA(1) };
+        EXPECT_EQ(FileImageScanner::findAll(*view, needle, {}, 0), expected);
+        EXPECT_EQ(FileImageScanner::findAll(*view, needle, SectionFilter::executable()).size(), 1);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(MappedFile{ path }, std::system_error);
+}
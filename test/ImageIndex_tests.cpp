@@ -0,0 +1,122 @@
+#include "B3L/ImageIndex.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+namespace {
+    std::vector<uint8_t> randomBytes(size_t size, int max, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, max);
+
+        std::vector<uint8_t> bytes(size);
+        for(auto& b : bytes)
+            b = static_cast<uint8_t>(dist(rng));
+        return bytes;
+    }
+
+    // Addresses of all matches found by a linear scan.
+    std::vector<uint64_t> scan(const std::vector<ImageIndex::Section>& sections, const AOBPattern& pattern) {
+        std::vector<uint64_t> result;
+        for(const auto& section : sections) {
+            for(auto it : AOBScanner::findAll(section.data.begin(), section.data.end(), pattern))
+                result.push_back(section.address + (it - section.data.begin()));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+} // namespace
+
+TEST(ImageIndexTests, FindAllMatchesScan) {
+    // Small alphabets produce long repeats, which stress the suffix sorting
+    const auto text = randomBytes(64 * 1024, 3, 5);
+    const auto code = randomBytes(16 * 1024, 255, 6);
+    const std::vector<uint8_t> runs(4096, 0xCC);
+
+    const std::vector<ImageIndex::Section> sections{ { 0x1000, text }, { 0x20000, code }, { 0x30000, runs } };
+    const ImageIndex index(sections, 2);
+
+    for(const auto& str : { "01 02 03 00", "03 ?? 03 ?? 03", "CC CC CC", "?? 02 0? 01 ?? 00", "4? ?? 0?", "FF FE FD FC FB" }) {
+        const auto pattern  = AOBPattern::fromString(str).value();
+        const auto expected = scan(sections, pattern);
+
+        EXPECT_EQ(index.findAll(pattern), expected) << str;
+        if(expected.empty())
+            EXPECT_FALSE(index.find(pattern)) << str;
+        else
+            EXPECT_EQ(index.find(pattern), expected.front()) << str;
+    }
+
+    // Exact needles taken from the data
+    for(size_t offset : { 0, 777, 40000, 65530 }) {
+        const auto needle = std::span(text).subspan(offset, 6);
+        const auto all    = index.findAll(needle);
+        EXPECT_EQ(all, scan(sections, AOBPattern::fromBytes(needle, std::vector<uint8_t>(6, 0xFF)).value()));
+        EXPECT_EQ(index.count(needle), all.size());
+        EXPECT_NE(std::find(all.begin(), all.end(), 0x1000 + offset), all.end());
+    }
+
+    EXPECT_EQ(index.count(std::vector<uint8_t>(4096, 0xCC)), 1u);
+    EXPECT_EQ(index.count(std::vector<uint8_t>(4097, 0xCC)), 0u);
+    EXPECT_EQ(index.count(std::vector<uint8_t>{}), 0u);
+}
+
+TEST(ImageIndexTests, SaveLoad) {
+    auto data = randomBytes(8192, 15, 9);
+    const std::vector<ImageIndex::Section> sections{ { 0x401000, data } };
+    const auto path = std::filesystem::temp_directory_path() / "B3L_ImageIndexTests_SaveLoad.idx";
+
+    ImageIndex(sections).save(path);
+
+    const auto pattern = AOBPattern::fromString("01 ?? 0E 0F").value();
+    auto loaded        = ImageIndex::load(path, sections);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->findAll(pattern), scan(sections, pattern));
+
+    // Sections that differ from the indexed ones
+    EXPECT_FALSE(ImageIndex::load(path, { { 0x402000, data } }));
+    EXPECT_FALSE(ImageIndex::load(path, { { 0x401000, std::span(data).first(4096) } }));
+    data[100] ^= 1;
+    EXPECT_FALSE(ImageIndex::load(path, sections));
+
+    std::filesystem::remove(path);
+    EXPECT_FALSE(ImageIndex::load(path, sections));
+}
+
+// Suffix arrays whose entries are in range but in the wrong order would silently return wrong matches.
+TEST(ImageIndexTests, LoadCorruptFile) {
+    const auto data = randomBytes(4096, 15, 10);
+    const std::vector<ImageIndex::Section> sections{ { 0x401000, data } };
+    const auto path = std::filesystem::temp_directory_path() / "B3L_ImageIndexTests_Corrupt.idx";
+    auto temp       = path;
+    temp += ".tmp";
+
+    ImageIndex(sections).save(path);
+    EXPECT_FALSE(std::filesystem::exists(temp));
+    ASSERT_TRUE(ImageIndex::load(path, sections));
+
+    std::vector<char> contents(std::filesystem::file_size(path));
+    std::ifstream(path, std::ios::binary).read(contents.data(), contents.size());
+    auto write = [&](const std::vector<char>& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+    };
+
+    // Swap the first two entries of the suffix array, which ends the file
+    auto swapped     = contents;
+    const auto entry = swapped.end() - data.size() * sizeof(uint32_t);
+    std::swap_ranges(entry, entry + sizeof(uint32_t), entry + sizeof(uint32_t));
+    write(swapped);
+    EXPECT_FALSE(ImageIndex::load(path, sections));
+
+    auto trailing = contents;
+    trailing.push_back(0);
+    write(trailing);
+    EXPECT_FALSE(ImageIndex::load(path, sections));
+
+    write(contents);
+    EXPECT_TRUE(ImageIndex::load(path, sections));
+
+    std::filesystem::remove(path);
+}
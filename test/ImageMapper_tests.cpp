@@ -0,0 +1,184 @@
+#include "B3L/ImageMapper.h"
+#include "TestImage.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#ifdef __linux__
+    #include <sstream>
+    #include <unistd.h>
+#endif
+
+using namespace B3L;
+
+namespace {
+    constexpr uint64_t pointer = TestImage::imageBase + 0x1010;
+
+    // Code, a pointer into code with its relocation, imports and a section that is mostly zero fill.
+    TestImage mappableImage() {
+        std::vector<uint8_t> data(0x100, 0xAB);
+        std::memcpy(data.data() + 0x20, &pointer, sizeof(pointer));
+
+        TestImage image;
+        image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0xCC) });
+        image.sections.push_back({ ".data", PE::SectionCharacteristics::MemRead | PE::SectionCharacteristics::MemWrite, data, 0x40 });
+        image.addImportSection({ { "KERNEL32.dll", { "VirtualAlloc" }, { 7 } } });
+        image.addRelocationSection({ { TestImage::sectionRVA(1) + 0x20 } });
+        return image;
+    }
+
+    void expectMapped(const ImageMapper& mapper) {
+        const auto& view = mapper.view();
+        EXPECT_EQ(view.baseAddress(), reinterpret_cast<uintptr_t>(mapper.data()));
+        EXPECT_EQ(mapper.size(), TestImage::sectionRVA(4));
+        EXPECT_EQ(view.optionalHeader()->ImageBase, view.baseAddress());
+        EXPECT_EQ(view.sectionName(2), ".idata");
+
+        const auto text = view.sectionData(0);
+        EXPECT_TRUE(std::all_of(text.begin(), text.end(), [](uint8_t b) { return b == 0xCC; }));
+
+        // Relocated to the mapping, data past VirtualSize is zero fill
+        const auto data = mapper.data() + TestImage::sectionRVA(1);
+        uint64_t relocated;
+        std::memcpy(&relocated, data + 0x20, sizeof(relocated));
+        EXPECT_EQ(relocated, view.baseAddress() + 0x1010);
+        EXPECT_TRUE(std::all_of(data + 0x40, data + TestImage::sectionAlignment, [](uint8_t b) { return b == 0; }));
+    }
+
+#ifdef __linux__
+    // Path of the file backing the mapping that contains address, empty for anonymous memory.
+    std::string mappedFileOf(const void* address) {
+        const auto value = reinterpret_cast<uintptr_t>(address);
+
+        std::ifstream maps("/proc/self/maps");
+        for(std::string line; std::getline(maps, line);) {
+            std::istringstream fields(line);
+            std::string range, permissions, offset, device, inode, file;
+            fields >> range >> permissions >> offset >> device >> inode;
+            std::getline(fields >> std::ws, file);
+
+            const auto dash  = range.find('-');
+            const auto begin = std::stoull(range.substr(0, dash), nullptr, 16);
+            const auto end   = std::stoull(range.substr(dash + 1), nullptr, 16);
+            if(value >= begin && value < end)
+                return file;
+        }
+        return {};
+    }
+#endif
+} // namespace
+
+TEST(ImageMapperTests, MapBuffer) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto file = mappableImage().build();
+    const ImageMapper mapper(file, [](const ImageView::Import& import) -> uintptr_t {
+        return import.importedByName() ? 0x1000 : 0x2000 + import.ordinal();
+    });
+    expectMapped(mapper);
+
+    std::vector<uintptr_t> iat;
+    for(auto it = mapper.view().importsBegin(); it != mapper.view().importsEnd(); ++it)
+        iat.push_back(*it->IATEntryAddress());
+    EXPECT_EQ(iat, (std::vector<uintptr_t>{ 0x1000, 0x2007 }));
+
+    // Imports keep the lookup table values without a resolver
+    const ImageMapper unresolved(file);
+    auto import = unresolved.view().importsBegin();
+    EXPECT_LT(*import->IATEntryAddress(), unresolved.size());
+    EXPECT_EQ(*(++import)->IATEntryAddress(), PE::ordinalFlag64 | 7);
+}
+
+TEST(ImageMapperTests, MapFile) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto path = std::filesystem::temp_directory_path() / "B3L_ImageMapperTests_MapFile.dll";
+
+    // Page aligned raw data is mapped from the file
+    for(uint32_t alignment : { TestImage::fileAlignment, TestImage::sectionAlignment }) {
+        {
+            const auto file = mappableImage().build(alignment);
+            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        }
+
+        auto mapper = ImageMapper(path, [](const ImageView::Import&) -> uintptr_t { return 0; });
+        const auto moved = std::move(mapper);
+        expectMapped(moved);
+        EXPECT_EQ(*moved.view().importsBegin()->IATEntryAddress(), 0u);
+
+#ifdef __linux__
+        // Only page aligned raw data is mapped from the file, the rest is copied into anonymous memory
+        const auto backing = mappedFileOf(moved.data() + TestImage::sectionRVA(0));
+        if(alignment == TestImage::sectionAlignment && static_cast<size_t>(sysconf(_SC_PAGESIZE)) <= alignment)
+            EXPECT_EQ(backing, std::filesystem::canonical(path).string());
+        else
+            EXPECT_TRUE(backing.empty()) << backing;
+#endif
+
+        // Mappings are private
+        moved.data()[TestImage::sectionRVA(0)] = 0x90;
+        EXPECT_EQ(ImageMapper(path).data()[TestImage::sectionRVA(0)], 0xCC);
+    }
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(ImageMapper{ path }, std::system_error);
+}
+
+TEST(ImageMapperTests, InvalidImage) {
+    std::vector<uint8_t> file(0x400);
+    EXPECT_THROW(ImageMapper{ file }, std::runtime_error);
+
+    // Sections past SizeOfImage
+    auto image                    = mappableImage();
+    image.sections[0].virtualSize = 0x1000;
+    auto built          = image.build();
+    const auto optional = sizeof(PE::DosHeader) + sizeof(uint32_t) + sizeof(PE::FileHeader);
+    const uint32_t size = TestImage::sectionRVA(0) + 0x800;
+    std::memcpy(built.data() + optional + offsetof(PE::OptionalHeader64, SizeOfImage), &size, sizeof(size));
+    EXPECT_THROW(ImageMapper{ built }, std::runtime_error);
+}
+
+// Import structures pointing outside of the mapping are rejected before the resolver writes the IAT.
+TEST(ImageMapperTests, ImportsOutsideOfImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    auto resolver       = [](const ImageView::Import&) -> uintptr_t { return 0x1234; };
+    auto withDescriptor = [](auto&& modify) {
+        auto image = mappableImage();
+        PE::ImportDescriptor descriptor;
+        std::memcpy(&descriptor, image.sections[2].data.data(), sizeof(descriptor));
+        modify(image, descriptor);
+        std::memcpy(image.sections[2].data.data(), &descriptor, sizeof(descriptor));
+        return image.build();
+    };
+
+    const auto firstThunk = withDescriptor([](TestImage&, PE::ImportDescriptor& descriptor) {
+        descriptor.FirstThunk = 0x10000000;
+    });
+    EXPECT_THROW(ImageMapper(firstThunk, resolver), std::runtime_error);
+    EXPECT_NO_THROW(ImageMapper{ firstThunk });
+
+    const auto lookup = withDescriptor([](TestImage&, PE::ImportDescriptor& descriptor) {
+        descriptor.OriginalFirstThunk = 0xFFFFFFF0;
+    });
+    EXPECT_THROW(ImageMapper(lookup, resolver), std::runtime_error);
+
+    const auto moduleName = withDescriptor([](TestImage&, PE::ImportDescriptor& descriptor) {
+        descriptor.Name = 0x10000000;
+    });
+    EXPECT_THROW(ImageMapper(moduleName, resolver), std::runtime_error);
+
+    // Hint/name RVA of the first lookup table entry
+    const auto name = withDescriptor([](TestImage& image, PE::ImportDescriptor& descriptor) {
+        const PE::ThunkData64 thunk{ { 0x10000000 } };
+        const auto offset = descriptor.OriginalFirstThunk - TestImage::sectionRVA(2);
+        std::memcpy(image.sections[2].data.data() + offset, &thunk, sizeof(thunk));
+    });
+    EXPECT_THROW(ImageMapper(name, resolver), std::runtime_error);
+
+    EXPECT_NO_THROW(ImageMapper(withDescriptor([](TestImage&, PE::ImportDescriptor&) {}), resolver));
+}
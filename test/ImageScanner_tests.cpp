@@ -0,0 +1,83 @@
+#include "B3L/ImageScanner.h"
+#include "TestImage.h"
+#include <gtest/gtest.h>
+#ifdef _WIN32
+    #include "B3L/Process.h"
+    #include <Windows.h>
+#endif
+
+using namespace B3L;
+
+TEST(ImageScannerTests, SectionFilter) {
+    using namespace PE::SectionCharacteristics;
+
+    EXPECT_TRUE(SectionFilter{}.accepts(0, ".data"));
+
+    auto executable = SectionFilter::executable();
+    EXPECT_TRUE(executable.accepts(MemExecute | MemRead, ".text"));
+    EXPECT_FALSE(executable.accepts(MemRead | MemWrite, ".data"));
+
+    auto named = SectionFilter::named(".rdata");
+    EXPECT_TRUE(named.accepts(MemRead, ".rdata"));
+    EXPECT_FALSE(named.accepts(MemRead, ".rsrc"));
+
+    SectionFilter excluded;
+    excluded.excludedCharacteristics = MemWrite;
+    EXPECT_FALSE(excluded.accepts(MemRead | MemWrite, ".data"));
+}
+
+TEST(ImageScannerTests, FindAllInTestImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    TestImage image;
+    image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0x90) });
+    image.sections.push_back({ ".data", PE::SectionCharacteristics::MemWrite, std::vector<uint8_t>(0x100, 0xCC) });
+    image.sections.push_back({ ".text2", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0x90) });
+    image.sections[0].data[0x10] = image.sections[0].data[0x11] = 0xCC;
+    image.sections[2].data[0xFE] = image.sections[2].data[0xFF] = 0xCC;
+
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    const auto base   = view.baseAddress();
+
+    // Matches in .data are skipped, the last one ends with its section
+    const auto needle  = AOBPattern::fromString("CC CC").value();
+    const auto filter  = SectionFilter::executable();
+    const auto matches = ImageScanner::findAll(view, needle, filter, 0);
+    const std::vector<uintptr_t> expected{ base + TestImage::sectionRVA(0) + 0x10, base + TestImage::sectionRVA(2) + 0xFE };
+    EXPECT_EQ(matches, expected);
+
+    EXPECT_EQ(ImageScanner::findAll(view, needle, filter, 1), matches);
+    EXPECT_EQ(ImageScanner::find(view, needle, filter), matches.front());
+    EXPECT_EQ(ImageScanner::find(view, needle, SectionFilter::named(".data")), base + TestImage::sectionRVA(1));
+}
+
+#ifdef _WIN32
+TEST(ImageScannerTests, FindAllInExecutableSections) {
+    auto image = ImageView::createFromMappedImage(getModuleBaseAddress());
+    ASSERT_TRUE(image.has_value());
+
+    // Int3 padding between functions
+    auto needle  = AOBPattern::fromString("CC CC").value();
+    auto filter  = SectionFilter::executable();
+    auto matches = ImageScanner::findAll(*image, needle, filter, 0);
+    EXPECT_FALSE(matches.empty());
+
+    auto isInExecutableSection = [&](uintptr_t address) {
+        for(int i = 0; i < image->sectionCount(); ++i) {
+            auto data  = image->sectionData(i);
+            auto begin = rcast<uintptr_t>(data.data());
+            if(address >= begin && address < begin + data.size())
+                return (image->section(i)->Characteristics & IMAGE_SCN_MEM_EXECUTE) != 0;
+        }
+        return false;
+    };
+
+    for(auto address : matches)
+        EXPECT_TRUE(isInExecutableSection(address));
+
+    EXPECT_EQ(ImageScanner::findAll(*image, needle, filter, 1), matches);
+    EXPECT_EQ(ImageScanner::find(*image, needle, filter), matches.front());
+}
+#endif
@@ -1,8 +1,132 @@
 #include "B3L/ImageView.h"
-#include "B3L/Process.h"
-#include <Windows.h>
+#include "TestImage.h"
+#include <cstring>
 #include <gtest/gtest.h>
+#ifdef _WIN32
+    #include "B3L/Process.h"
+    #include <Windows.h>
+#endif
 
+using namespace B3L;
+
+namespace {
+    TestImage importingImage() {
+        TestImage image;
+        image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0xCC) });
+        image.addImportSection({ { "KERNEL32.dll", { "VirtualAlloc", "VirtualFree" }, {} }, { "WS2_32.dll", {}, { 23 } } });
+        return image;
+    }
+} // namespace
+
+TEST(ImageViewTests, CreateFromMappedTestImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto mapped = importingImage().buildMapped();
+
+    // The buffer is part of the heap
+    auto view = ImageView::createFromMappedImage(mapped.data());
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->baseAddress(), rcast<uintptr_t>(mapped.data()));
+    EXPECT_EQ(view->sectionCount(), 2);
+    EXPECT_EQ(view->sectionName(1), ".idata");
+    EXPECT_EQ(view->sectionData(0).data(), mapped.data() + TestImage::sectionRVA(0));
+    EXPECT_EQ(view->optionalHeader()->ImageBase, TestImage::imageBase);
+
+    const BufferMemoryQuery buffer(mapped);
+    EXPECT_TRUE(ImageView::createFromMappedImage(mapped.data(), buffer));
+
+    // Sections that extend past the mapped memory
+    const BufferMemoryQuery truncated{ std::span(mapped).first(TestImage::sectionRVA(1)) };
+    EXPECT_FALSE(ImageView::createFromMappedImage(mapped.data(), truncated));
+
+    auto badSignature = mapped;
+    badSignature[0]   = 'X';
+    EXPECT_FALSE(ImageView::createFromMappedImage(badSignature.data(), BufferMemoryQuery(badSignature)));
+}
+
+TEST(ImageViewTests, ImportIteratorTestImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    const auto mapped = importingImage().buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+
+    std::vector<std::string> imports;
+    for(auto it = view.importsBegin(); it != view.importsEnd(); ++it) {
+        if(it->importedByName())
+            imports.push_back(std::string(it->moduleName()) + "!" + it->name());
+        else
+            imports.push_back(std::string(it->moduleName()) + "#" + std::to_string(it->ordinal()));
+
+        EXPECT_GE(rcast<const uint8_t*>(it->IATEntryAddress()), view.sectionData(1).data());
+    }
+    EXPECT_EQ(imports, (std::vector<std::string>{ "KERNEL32.dll!VirtualAlloc", "KERNEL32.dll!VirtualFree", "WS2_32.dll#23" }));
+
+    // Images without imports
+    TestImage plain;
+    plain.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x10, 0xC3) });
+    const auto plainMapped = plain.buildMapped();
+    const auto plainView   = ImageView::createFromMappedImage(plainMapped.data(), BufferMemoryQuery(plainMapped)).value();
+    EXPECT_EQ(plainView.importsBegin(), plainView.importsEnd());
+}
+
+TEST(ImageViewTests, ExportIteratorTestImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    TestImage image;
+    image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0xCC) });
+    image.addExportSection("test.dll", 5, { { "Zeta", 0x1010, {} }, { "", 0x1020, {} }, { "Alpha", 0x1000, {} } });
+
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    ASSERT_NE(view.exportDirectory(), nullptr);
+
+    std::vector<std::string> names;
+    for(auto it = view.exportsBegin(); it != view.exportsEnd(); it++) {
+        names.push_back(it->name());
+        EXPECT_FALSE(it->isForwarded());
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{ "Alpha", "Zeta" }));
+
+    const auto first = *view.exportsBegin();
+    EXPECT_EQ(first.ordinal(), 7u);
+    EXPECT_EQ(first.address(), view.baseAddress() + 0x1000);
+
+    // Images without exports
+    const auto importing     = importingImage().buildMapped();
+    const auto importingView = ImageView::createFromMappedImage(importing.data(), BufferMemoryQuery(importing)).value();
+    EXPECT_EQ(importingView.exportDirectory(), nullptr);
+    EXPECT_EQ(importingView.exportsBegin(), importingView.exportsEnd());
+}
+
+TEST(ImageViewTests, RelocationIteratorTestImage) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    auto image = importingImage();
+    image.addRelocationSection({ { 0x1010 }, { 0x2008, PE::RelocationType::HighLow }, { 0x1000 } });
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+
+    std::vector<std::pair<uint32_t, std::vector<uint16_t>>> blocks;
+    for(auto it = view.relocationsBegin(); it != view.relocationsEnd(); ++it)
+        blocks.push_back({ it->pageRVA(), { it->entries().begin(), it->entries().end() } });
+
+    ASSERT_EQ(blocks.size(), 2u);
+    EXPECT_EQ(blocks[0], (std::pair<uint32_t, std::vector<uint16_t>>{ 0x1000, { 0xA010, 0xA000 } }));
+    EXPECT_EQ(blocks[1], (std::pair<uint32_t, std::vector<uint16_t>>{ 0x2000, { 0x3008, 0x0000 } }));
+    EXPECT_EQ(ImageView::RelocationBlock::type(blocks[1].second[0]), PE::RelocationType::HighLow);
+    EXPECT_EQ(ImageView::RelocationBlock::offset(blocks[1].second[0]), 8u);
+
+    // Images without relocations
+    const auto plain     = importingImage().buildMapped();
+    const auto plainView = ImageView::createFromMappedImage(plain.data(), BufferMemoryQuery(plain)).value();
+    EXPECT_EQ(plainView.relocationsBegin(), plainView.relocationsEnd());
+}
+
+#ifdef _WIN32
 TEST(ImageViewTests, Construct) {
     auto moduleBase = B3L::getModuleBaseAddress();
     auto imageView  = B3L::ImageView::createFromMappedImage(moduleBase);
@@ -31,4 +155,5 @@ TEST(ImageViewTests, ImportIterator) {
         ++head;
     }
     EXPECT_TRUE(head != end);
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,62 @@
+#include "B3L/ImportIndex.h"
+#include "TestImage.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace B3L;
+
+TEST(ImportIndexTests, Lookup) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    std::vector<std::string> names;
+    for(int i = 0; i < 60; ++i)
+        names.push_back("Function" + std::to_string(i));
+
+    TestImage image;
+    image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x100, 0xCC) });
+    image.addImportSection({ { "KERNEL32.dll", { "VirtualAlloc", "VirtualFree" }, { 7 } },
+                             { "game.dll", names, {} },
+                             { "WS2_32.dll", { "VirtualAlloc" }, { 23, 7 } } });
+
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    const ImportIndex index(view);
+    EXPECT_EQ(index.size(), 66u);
+
+    // Every entry resolves to its own IAT slot, in the order of the import directory
+    std::vector<const uintptr_t*> entries;
+    for(auto it = view.importsBegin(); it != view.importsEnd(); ++it)
+        entries.push_back(it->IATEntryAddress());
+
+    EXPECT_EQ(index.find("KERNEL32.dll", "VirtualAlloc")->IATEntryAddress(), entries[0]);
+    EXPECT_EQ(index.find("kernel32.DLL", "VirtualFree")->IATEntryAddress(), entries[1]);
+    EXPECT_EQ(index.find("kernel32.dll", 7)->IATEntryAddress(), entries[2]);
+    for(int i = 0; i < 60; ++i)
+        EXPECT_EQ(index.find("game.dll", names[i])->IATEntryAddress(), entries[3 + i]);
+    EXPECT_EQ(index.find("ws2_32.dll", "VirtualAlloc")->IATEntryAddress(), entries[63]);
+    EXPECT_EQ(index.find("ws2_32.dll", 7)->IATEntryAddress(), entries[65]);
+
+    // Names are case-sensitive, modules have to match
+    EXPECT_FALSE(index.find("KERNEL32.dll", "virtualalloc"));
+    EXPECT_FALSE(index.find("KERNEL32", "VirtualAlloc"));
+    EXPECT_FALSE(index.find("game.dll", "Function60"));
+    EXPECT_FALSE(index.find("WS2_32.dll", 24));
+    EXPECT_FALSE(index.find("WS2_32.dll", -1));
+    EXPECT_FALSE(index.find("WS2_32.dll", ""));
+}
+
+TEST(ImportIndexTests, ImageWithoutImports) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    TestImage image;
+    image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x10, 0xC3) });
+    const auto mapped = image.buildMapped();
+    const auto view   = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+
+    const ImportIndex index(view);
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_FALSE(index.find("KERNEL32.dll", "VirtualAlloc"));
+    EXPECT_FALSE(index.find("KERNEL32.dll", 1));
+}
@@ -0,0 +1,74 @@
+#include "B3L/MultiPatternScanner.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+TEST(MultiPatternScannerTests, Scan) {
+    std::vector<uint8_t> haystack{ 0x8B, 0x0C, 0x08, 0xE8, 0x74, 0xED, 0xED, 0xFF, 0x48, 0x89 };
+
+    std::vector<AOBPattern> patterns;
+    patterns.push_back(AOBPattern::fromString("ED ?? FF 48 89").value());
+    patterns.push_back(AOBPattern::fromString("ED").value());
+    patterns.push_back(AOBPattern::fromString("0C ?? E8").value());
+    patterns.push_back(AOBPattern::fromString("11 22").value());
+
+    MultiPatternScanner scanner(std::move(patterns));
+    auto matches = scanner.scan(haystack);
+
+    std::vector<MultiPatternScanner::Match> expected{ { 2, 1 }, { 0, 5 }, { 1, 5 }, { 1, 6 } };
+    EXPECT_EQ(matches, expected);
+}
+
+// Single pass results have to agree with one AOBScanner pass per pattern.
+TEST(MultiPatternScannerTests, ScanMatchesAOBScanner) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> haystack(2048);
+    for(auto& b : haystack)
+        b = static_cast<uint8_t>(dist(rng));
+
+    std::vector<AOBPattern> patterns;
+    for(const auto& str : { "01 02 03", "?? 03 ?? 01", "00", "03 ?? 03 ?? 03", "?? ??", "02 ?? ?? ?? ?? 01 01" })
+        patterns.push_back(AOBPattern::fromString(str).value());
+
+    MultiPatternScanner scanner(patterns);
+    auto matches = scanner.scan(haystack);
+
+    std::vector<MultiPatternScanner::Match> expected;
+    for(size_t id = 0; id < patterns.size(); ++id) {
+        auto it = haystack.begin();
+        while((it = AOBScanner::find(it, haystack.end(), patterns[id])) != haystack.end()) {
+            expected.push_back({ id, static_cast<size_t>(it - haystack.begin()) });
+            ++it;
+        }
+    }
+    std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.patternId < b.patternId;
+    });
+
+    EXPECT_EQ(matches, expected);
+}
+
+TEST(MultiPatternScannerTests, Resolve) {
+    std::vector<uint8_t> haystack{ 0xCC, 0xE8, 0x10, 0x00, 0x00, 0x00, 0x48, 0x8B, 0x05, 0xF0, 0xFF, 0xFF, 0xFF, 0xE8, 0x00 };
+
+    std::vector<AOBPattern> patterns;
+    patterns.push_back(AOBPattern::fromString("E8 <rel4> 48 8B").value());
+    patterns.push_back(AOBPattern::fromString("48 8B 05 <global:rel4>").value());
+    patterns.push_back(AOBPattern::fromString("CC E8").value());
+    patterns.push_back(AOBPattern::fromString("11 22").value());
+
+    MultiPatternScanner scanner(std::move(patterns));
+    auto results = scanner.resolve(haystack, 0x1000);
+
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_EQ(results[0], 0x1006u + 0x10);
+    EXPECT_EQ(results[1], 0x100Du - 0x10);
+    EXPECT_EQ(results[2], 0x1000u);
+    EXPECT_FALSE(results[3]);
+
+    auto local = scanner.resolve(haystack);
+    EXPECT_EQ(local[2], reinterpret_cast<uintptr_t>(haystack.data()));
+}
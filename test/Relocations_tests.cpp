@@ -0,0 +1,123 @@
+#include "B3L/FileImageView.h"
+#include "B3L/ImageView.h"
+#include "B3L/Relocations.h"
+#include "TestImage.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+namespace {
+    template <typename T>
+    T read(const std::vector<uint8_t>& image, uint32_t rva) {
+        T value;
+        std::memcpy(&value, image.data() + rva, sizeof(value));
+        return value;
+    }
+
+    // Runs of adjacent DIR64 fields followed by scattered DIR64 and HIGHLOW fields and padding.
+    std::vector<TestImage::Relocation> mixedRelocations(uint32_t dataRVA) {
+        std::vector<TestImage::Relocation> relocations;
+        for(uint32_t offset = 0x100; offset < 0x100 + 20 * 8; offset += 8)
+            relocations.push_back({ dataRVA + offset });
+        for(uint32_t offset = 0xA00; offset < 0xA00 + 9 * 8; offset += 8)
+            relocations.push_back({ dataRVA + offset });
+
+        const auto runs = relocations.size();
+        for(uint32_t offset = 0x400; offset < 0x800; offset += 24)
+            relocations.push_back({ dataRVA + offset });
+        for(uint32_t offset = 0x800; offset < 0x900; offset += 12)
+            relocations.push_back({ dataRVA + offset, PE::RelocationType::HighLow });
+        relocations.push_back({ dataRVA + 0xFF8 });
+        relocations.push_back({ dataRVA, PE::RelocationType::Absolute });
+
+        std::shuffle(relocations.begin() + runs, relocations.end(), std::mt19937(7));
+        return relocations;
+    }
+} // namespace
+
+TEST(RelocationsTests, ApplyRelocations) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    std::mt19937 rng(3);
+    std::vector<uint8_t> data(0x1000);
+    for(auto& byte : data)
+        byte = static_cast<uint8_t>(rng());
+
+    TestImage image;
+    image.sections.push_back({ ".data", PE::SectionCharacteristics::MemRead, data });
+    const auto relocations = mixedRelocations(TestImage::sectionRVA(0));
+    image.addRelocationSection(relocations);
+
+    const auto original = image.buildMapped();
+    const uint64_t delta = 0x10'0000'0000'1000;
+
+    for(unsigned threadCount : { 1u, 4u }) {
+        auto mapped = original;
+        ASSERT_TRUE(applyRelocations(mapped, TestImage::imageBase + delta, threadCount));
+
+        const auto view = ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+        EXPECT_EQ(view.optionalHeader()->ImageBase, TestImage::imageBase + delta);
+
+        // Relocated fields changed by delta, section data is untouched otherwise
+        auto expected = original;
+        for(const auto& relocation : relocations) {
+            if(relocation.type == PE::RelocationType::Dir64) {
+                const auto value = read<uint64_t>(original, relocation.rva) + delta;
+                std::memcpy(expected.data() + relocation.rva, &value, sizeof(value));
+            } else if(relocation.type == PE::RelocationType::HighLow) {
+                const auto value = read<uint32_t>(original, relocation.rva) + static_cast<uint32_t>(delta);
+                std::memcpy(expected.data() + relocation.rva, &value, sizeof(value));
+            }
+        }
+        EXPECT_TRUE(std::equal(mapped.begin() + TestImage::sectionRVA(0), mapped.end(), expected.begin() + TestImage::sectionRVA(0)));
+
+        // Rebasing back restores the image
+        ASSERT_TRUE(applyRelocations(mapped, TestImage::imageBase, threadCount));
+        EXPECT_EQ(mapped, original);
+    }
+}
+
+TEST(RelocationsTests, InvalidImage) {
+    std::vector<uint8_t> buffer(0x2000);
+    EXPECT_FALSE(applyRelocations(buffer, 0x10000));
+}
+
+// PE32 images are relocated on 64 bit hosts as well, ImageView doesn't accept them there.
+TEST(RelocationsTests, ApplyRelocationsPE32) {
+    std::mt19937 rng(5);
+    std::vector<uint8_t> data(0x1000);
+    for(auto& byte : data)
+        byte = static_cast<uint8_t>(rng());
+
+    TestImage image;
+    image.pe32 = true;
+    image.sections.push_back({ ".data", PE::SectionCharacteristics::MemRead, data });
+
+    std::vector<TestImage::Relocation> relocations;
+    for(uint32_t offset = 0; offset < 0x1000; offset += 20)
+        relocations.push_back({ TestImage::sectionRVA(0) + offset, PE::RelocationType::HighLow });
+    image.addRelocationSection(relocations);
+
+    const auto original = image.buildMapped();
+    const uint32_t delta = 0x1230000;
+
+    auto mapped = original;
+    ASSERT_TRUE(applyRelocations(mapped, TestImage::imageBase32 + delta));
+
+    const auto view = FileImageView::create(mapped).value();
+    EXPECT_FALSE(view.is64Bit());
+    EXPECT_EQ(view.preferredImageBase(), TestImage::imageBase32 + delta);
+
+    for(const auto& relocation : relocations)
+        EXPECT_EQ(read<uint32_t>(mapped, relocation.rva), read<uint32_t>(original, relocation.rva) + delta);
+    EXPECT_EQ(read<uint32_t>(mapped, TestImage::sectionRVA(0) + 4), read<uint32_t>(original, TestImage::sectionRVA(0) + 4));
+
+    // ImageBase is 32 bit
+    EXPECT_FALSE(applyRelocations(mapped, uint64_t{ 1 } << 32));
+
+    ASSERT_TRUE(applyRelocations(mapped, TestImage::imageBase32));
+    EXPECT_EQ(mapped, original);
+}
@@ -0,0 +1,116 @@
+#include "B3L/RemoteScanner.h"
+#include <gtest/gtest.h>
+#include <numeric>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <csignal>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace B3L;
+
+namespace {
+
+    ProcessId currentProcessId() {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return getpid();
+#endif
+    }
+
+    // Heap buffer with a pattern at offset, all other bytes are distinct from the pattern bytes.
+    struct TestBuffer {
+        static constexpr size_t size = 64 * 1024;
+
+        std::vector<uint8_t> storage = std::vector<uint8_t>(size, 0x11);
+
+        RemoteMemorySource::Region region() const {
+            return { reinterpret_cast<uint64_t>(storage.data()), storage.size() };
+        }
+
+        uint64_t place(size_t offset) {
+            const uint8_t bytes[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x42 };
+            std::copy(std::begin(bytes), std::end(bytes), storage.begin() + offset);
+            return reinterpret_cast<uint64_t>(storage.data()) + offset;
+        }
+    };
+
+} // namespace
+
+TEST(RemoteScannerTests, Read) {
+    std::vector<uint8_t> first(100);
+    std::vector<uint8_t> second(3000);
+    std::iota(first.begin(), first.end(), uint8_t{ 0 });
+    std::iota(second.begin(), second.end(), uint8_t{ 7 });
+
+    RemoteMemorySource source(currentProcessId());
+
+    const RemoteMemorySource::Region ranges[] = { { reinterpret_cast<uint64_t>(first.data()), first.size() },
+                                                  { 0, 16 }, // Unmapped
+                                                  { reinterpret_cast<uint64_t>(second.data()), second.size() } };
+    std::vector<uint8_t> buffer(first.size() + 16 + second.size());
+    std::vector<size_t> bytesRead(3);
+
+    EXPECT_EQ(source.read(ranges, buffer.data(), bytesRead), first.size() + second.size());
+    EXPECT_EQ(bytesRead, (std::vector<size_t>{ first.size(), 0, second.size() }));
+    EXPECT_TRUE(std::equal(first.begin(), first.end(), buffer.begin()));
+    EXPECT_TRUE(std::equal(second.begin(), second.end(), buffer.begin() + first.size() + 16));
+}
+
+TEST(RemoteScannerTests, FindAllBlockBorders) {
+    TestBuffer buffer;
+    auto needle = AOBPattern::fromString("DE AD ?? EF 42").value();
+
+    // Matches at the start, crossing the borders of 4 KiB blocks and at the very end
+    const std::vector<uint64_t> expected = { buffer.place(0), buffer.place(4096 - 2), buffer.place(3 * 4096 - 4),
+                                             buffer.place(TestBuffer::size - 5) };
+
+    RemoteMemorySource source(currentProcessId());
+    const auto region = buffer.region();
+
+    EXPECT_EQ(RemoteScanner::findAll(source, { &region, 1 }, needle, 4096), expected);
+    EXPECT_EQ(RemoteScanner::findAll(source, { &region, 1 }, needle), expected);
+}
+
+#ifndef _WIN32
+
+TEST(RemoteScannerTests, FindAllChildProcess) {
+    TestBuffer buffer;
+    const auto address = buffer.place(12345);
+
+    // The child inherits the buffer at the same address
+    const auto child = fork();
+    ASSERT_NE(child, -1);
+    if(child == 0) {
+        pause();
+        _exit(0);
+    }
+
+    // Overwrite the parent copy, only the child still holds the pattern
+    std::fill(buffer.storage.begin(), buffer.storage.end(), uint8_t{ 0x11 });
+
+    {
+        RemoteMemorySource source(child);
+        const auto region = buffer.region();
+        auto needle       = AOBPattern::fromString("DE AD BE EF 42").value();
+
+        EXPECT_EQ(RemoteScanner::findAll(source, { &region, 1 }, needle, 4096), std::vector<uint64_t>{ address });
+
+        const auto regions = source.regions();
+        EXPECT_TRUE(std::any_of(regions.begin(), regions.end(), [&](const auto& r) {
+            return address >= r.address && address < r.address + r.size;
+        }));
+
+        const auto matches = RemoteScanner::findAll(source, needle);
+        EXPECT_NE(std::find(matches.begin(), matches.end(), address), matches.end());
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "B3L/SignatureCache.h"
+#include "TestImage.h"
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace B3L;
+
+namespace {
+    const uint8_t signatureBytes[] = { 0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44 };
+
+    // Image with the signature bytes at each of offsets in .text and at offset 0 of .data.
+    std::vector<uint8_t> signatureImage(std::initializer_list<uint32_t> offsets, uint32_t timeDateStamp = 0x5F000000) {
+        TestImage image;
+        image.timeDateStamp = timeDateStamp;
+        image.sections.push_back({ ".text", PE::SectionCharacteristics::MemExecute, std::vector<uint8_t>(0x200, 0xCC) });
+        image.sections.push_back({ ".data", PE::SectionCharacteristics::MemWrite, std::vector<uint8_t>(0x100) });
+
+        for(auto offset : offsets)
+            std::copy(std::begin(signatureBytes), std::end(signatureBytes), image.sections[0].data.begin() + offset);
+        std::copy(std::begin(signatureBytes), std::end(signatureBytes), image.sections[1].data.begin());
+
+        return image.buildMapped();
+    }
+
+    ImageView view(const std::vector<uint8_t>& mapped) {
+        return ImageView::createFromMappedImage(mapped.data(), BufferMemoryQuery(mapped)).value();
+    }
+
+    const AOBPattern& signature() {
+        static const std::vector<uint8_t> mask(sizeof(signatureBytes), 0xFF);
+        static const auto pattern = AOBPattern::fromBytes(signatureBytes, mask).value();
+        return pattern;
+    }
+} // namespace
+
+TEST(SignatureCacheTests, ResolveAndReload) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    auto path = std::filesystem::temp_directory_path() / "B3L_SignatureCacheTests.bin";
+    std::filesystem::remove(path);
+
+    const auto mapped = signatureImage({ 0x40 });
+    const auto image  = view(mapped);
+    const auto filter = SectionFilter::executable();
+
+    {
+        SignatureCache cache(path);
+        EXPECT_EQ(cache.size(), 0);
+
+        const auto rva = cache.resolve(image, signature(), filter);
+        ASSERT_TRUE(rva.has_value());
+        EXPECT_EQ(*rva, TestImage::sectionRVA(0) + 0x40);
+        EXPECT_EQ(image.baseAddress() + *rva, ImageScanner::find(image, signature(), filter));
+        EXPECT_EQ(cache.resolve(image, signature(), filter), rva);
+        EXPECT_EQ(cache.size(), 1);
+
+        // The filter is part of the key
+        EXPECT_EQ(cache.resolve(image, signature(), SectionFilter::named(".data")), TestImage::sectionRVA(1));
+        EXPECT_EQ(cache.size(), 2);
+
+        // Unresolved patterns are not cached
+        EXPECT_FALSE(cache.resolve(image, signature(), SectionFilter::named("B3L_none")).has_value());
+        EXPECT_EQ(cache.size(), 2);
+
+        cache.save();
+    }
+
+    SignatureCache cache(path);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.resolve(image, signature(), filter), TestImage::sectionRVA(0) + 0x40);
+
+    std::filesystem::remove(path);
+}
+
+// Entries whose pattern moved or whose image identity changed are rescanned and replaced in the file.
+TEST(SignatureCacheTests, StaleEntries) {
+    if constexpr(!PE::native64Bit)
+        GTEST_SKIP() << "Test images are PE32+";
+
+    auto path = std::filesystem::temp_directory_path() / "B3L_SignatureCacheStale.bin";
+    auto temp = path;
+    temp += ".tmp";
+    std::filesystem::remove(path);
+
+    const auto filter = SectionFilter::executable();
+    const auto rvaA   = TestImage::sectionRVA(0) + 0x40;
+    const auto rvaB   = TestImage::sectionRVA(0) + 0x100;
+
+    {
+        SignatureCache cache(path);
+        EXPECT_EQ(cache.resolve(view(signatureImage({ 0x40 })), signature(), filter), rvaA);
+        cache.save();
+    }
+
+    // Same identity, the pattern moved from A to B
+    {
+        SignatureCache cache(path);
+        EXPECT_EQ(cache.resolve(view(signatureImage({ 0x100 })), signature(), filter), rvaB);
+        cache.save();
+        EXPECT_TRUE(std::filesystem::exists(path));
+        EXPECT_FALSE(std::filesystem::exists(temp));
+    }
+
+    // A scan finds A first, so only the rewritten entry yields B
+    const auto both = signatureImage({ 0x40, 0x100 });
+    EXPECT_EQ(SignatureCache(path).resolve(view(both), signature(), filter), rvaB);
+
+    // Rebuilt image where B still matches, the identity mismatch forces a scan
+    {
+        SignatureCache cache(path);
+        EXPECT_EQ(cache.resolve(view(signatureImage({ 0x40, 0x100 }, 0x60000000)), signature(), filter), rvaA);
+        cache.save();
+        EXPECT_FALSE(std::filesystem::exists(temp));
+    }
+
+    // The old identity no longer has an entry, so it's scanned as well
+    SignatureCache cache(path);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.resolve(view(both), signature(), filter), rvaA);
+
+    std::filesystem::remove(path);
+}
+
+TEST(SignatureCacheTests, MalformedFile) {
+    auto path = std::filesystem::temp_directory_path() / "B3L_SignatureCacheMalformed.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a cache";
+    }
+
+    SignatureCache cache(path);
+    EXPECT_EQ(cache.size(), 0);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,136 @@
+#include "B3L/SignatureDatabase.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+namespace {
+    std::vector<uint8_t> bytes(std::span<const uint8_t> span) {
+        return { span.begin(), span.end() };
+    }
+} // namespace
+
+TEST(SignatureDatabaseTests, Parse) {
+    const std::string text = "# Comment\n"
+                             "PlayerBase | 48 8B 05 <rel4> 48 85 C0 | .text | game.dll\n"
+                             "\n"
+                             "  Compact|488B??4?  \r\n"
+                             "{\"name\": \"Render\", \"pattern\": \"E8 ?? ?? ?? ?? 8B/F8\", \"section\": \".text\"}\n"
+                             "{ \"module\" : \"engine.dll\", \"extra\": \"\", \"pattern\": \"90 CC\", \"name\": \"Nop\" }\n"
+                             "NoPattern\n"
+                             "Bad | 48 8X\n"
+                             "{\"name\": \"Escaped\\\"\", \"pattern\": \"90\"}\n"
+                             "Empty | \n"
+                             "PlayerBase | C3";
+
+    const SignatureDatabase db(text);
+    ASSERT_EQ(db.size(), 5u);
+    EXPECT_EQ(std::vector<size_t>(db.errors().begin(), db.errors().end()), (std::vector<size_t>{ 7, 8, 9, 10 }));
+
+    const auto player = db[0];
+    EXPECT_EQ(player.name, "PlayerBase");
+    EXPECT_EQ(player.source, "48 8B 05 <rel4> 48 85 C0");
+    EXPECT_EQ(player.section, ".text");
+    EXPECT_EQ(player.module, "game.dll");
+    EXPECT_EQ(bytes(player.value), (std::vector<uint8_t>{ 0x48, 0x8B, 0x05, 0, 0, 0, 0, 0x48, 0x85, 0xC0 }));
+    EXPECT_EQ(bytes(player.mask), (std::vector<uint8_t>{ 0xFF, 0xFF, 0xFF, 0, 0, 0, 0, 0xFF, 0xFF, 0xFF }));
+
+    const auto compact = db[1];
+    EXPECT_EQ(compact.name, "Compact");
+    EXPECT_TRUE(compact.section.empty());
+    EXPECT_EQ(bytes(compact.mask), (std::vector<uint8_t>{ 0xFF, 0xFF, 0x00, 0xF0 }));
+
+    const auto render = db[2];
+    EXPECT_EQ(render.section, ".text");
+    EXPECT_EQ(render.sectionFilter().names, std::vector<std::string>{ ".text" });
+    EXPECT_EQ(render.mask.back(), 0xF8);
+
+    EXPECT_EQ(db[3].name, "Nop");
+    EXPECT_EQ(db[3].module, "engine.dll");
+
+    // Duplicate names resolve to the first signature
+    EXPECT_EQ(db.find("PlayerBase"), 0u);
+    EXPECT_EQ(db.find("Nop"), 3u);
+    EXPECT_FALSE(db.find("Missing"));
+
+    // Captures survive through the database
+    const auto pattern = db.pattern(0);
+    ASSERT_TRUE(pattern);
+    ASSERT_EQ(pattern->captures().size(), 1u);
+    EXPECT_EQ(pattern->captures()[0].kind, CaptureKind::Relative);
+    EXPECT_EQ(pattern->captures()[0].offset, 3u);
+    EXPECT_EQ(bytes(pattern->mask()), bytes(player.mask));
+
+    // Duplicate capture names parse but don't form a pattern, as with AOBPattern::fromString
+    const SignatureDatabase duplicates("Twice | E8 <a:rel4> E8 <a:rel4>");
+    ASSERT_EQ(duplicates.size(), 1u);
+    EXPECT_FALSE(duplicates.pattern(0));
+}
+
+// The SIMD layout path has to agree with AOBPattern::fromString wherever the layout breaks.
+TEST(SignatureDatabaseTests, DecodeMatchesFromString) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(0, 255);
+    const char* const digits = "0123456789ABCDEFabcdef";
+
+    // Explicit mask after whitespace following a full SIMD block
+    std::string text = "Spaced | 48 8B 05 48 8B /F0 90\n";
+    std::vector<std::string> patterns{ "48 8B 05 48 8B /F0 90" };
+    for(int i = 0; i < 200; ++i) {
+        std::string pattern;
+        const auto length = 1 + dist(rng) % 40;
+        for(int j = 0; j < length; ++j) {
+            const auto kind = dist(rng) % 16;
+            if(kind == 0)
+                pattern += "??";
+            else if(kind == 1)
+                pattern += std::string(1, digits[dist(rng) % 22]) + "?";
+            else if(kind == 2)
+                pattern += std::string("8B/F8");
+            else if(kind == 3)
+                pattern += std::string("8B /F0");
+            else if(kind == 4)
+                pattern += std::string("<rel4>");
+            else
+                pattern += std::string(1, digits[dist(rng) % 22]) + digits[dist(rng) % 22];
+
+            pattern += dist(rng) % 32 ? " " : "  ";
+        }
+        patterns.push_back(pattern);
+        text += "Signature" + std::to_string(i) + " | " + pattern + "\n";
+    }
+
+    const SignatureDatabase db(text);
+    ASSERT_EQ(db.size(), patterns.size());
+    for(size_t i = 0; i < patterns.size(); ++i) {
+        const auto expected = AOBPattern::fromString(patterns[i]).value();
+        EXPECT_EQ(bytes(db[i].value), bytes(expected.value())) << patterns[i];
+        EXPECT_EQ(bytes(db[i].mask), bytes(expected.mask())) << patterns[i];
+
+        const auto pattern = db.pattern(i);
+        ASSERT_TRUE(pattern) << patterns[i];
+        EXPECT_EQ(bytes(pattern->value()), bytes(expected.value())) << patterns[i];
+        ASSERT_EQ(pattern->captures().size(), expected.captures().size()) << patterns[i];
+        for(size_t j = 0; j < expected.captures().size(); ++j)
+            EXPECT_EQ(pattern->captures()[j].offset, expected.captures()[j].offset) << patterns[i];
+    }
+}
+
+TEST(SignatureDatabaseTests, Open) {
+    const auto path = std::filesystem::temp_directory_path() / "B3L_SignatureDatabaseTests_Open.sig";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "A | 01 02 03\n{\"name\": \"B\", \"pattern\": \"04 ?? 06\"}\n";
+    }
+
+    auto db = SignatureDatabase::open(path);
+    auto moved = std::move(db);
+    ASSERT_EQ(moved.size(), 2u);
+    EXPECT_EQ(moved[1].name, "B");
+    EXPECT_EQ(bytes(moved[1].value), (std::vector<uint8_t>{ 4, 0, 6 }));
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(SignatureDatabase::open(path), std::system_error);
+}
@@ -0,0 +1,107 @@
+#include "B3L/SignatureGenerator.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+namespace {
+    size_t countMatches(std::span<const uint8_t> data, const AOBPattern& pattern) {
+        return AOBScanner::findAll(data.begin(), data.end(), pattern).size();
+    }
+} // namespace
+
+TEST(SignatureGeneratorTests, ShortestUnique) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> dist(0, 3);
+
+    std::vector<uint8_t> code(64 * 1024);
+    for(auto& b : code)
+        b = static_cast<uint8_t>(dist(rng));
+
+    SignatureGenerator generator({ { 0x1000, code } });
+
+    for(size_t offset : { 0, 100, 5000, 40000 }) {
+        std::vector<uint8_t> value(code.begin() + offset, code.begin() + offset + 64);
+        std::vector<uint8_t> mask(value.size(), 0xFF);
+        mask[5] = mask[6] = 0;
+        value[5] = value[6] = 0;
+
+        auto pattern = generator.shortestUnique(0x1000 + offset, value, mask);
+        ASSERT_TRUE(pattern);
+        EXPECT_EQ(countMatches(code, *pattern), 1u);
+        EXPECT_TRUE(pattern->matchesAt(code.data() + offset));
+
+        // One byte less is ambiguous
+        auto shorter = AOBPattern::fromBytes(std::span(value).first(pattern->size() - 1),
+                                             std::span(mask).first(pattern->size() - 1));
+        EXPECT_GT(countMatches(code, *shorter), 1u);
+    }
+}
+
+TEST(SignatureGeneratorTests, ShortestUniqueAcrossRegions) {
+    // Identical code in two regions, only byte 20 differs
+    std::vector<uint8_t> first(32), second(32);
+    for(size_t i = 0; i < first.size(); ++i)
+        first[i] = second[i] = static_cast<uint8_t>(i * 7);
+    second[20] = 0xFF;
+
+    SignatureGenerator generator({ { 0x1000, first }, { 0x2000, second } });
+
+    std::vector<uint8_t> mask(32, 0xFF);
+    auto pattern = generator.shortestUnique(0x2000, second, mask);
+    ASSERT_TRUE(pattern);
+    EXPECT_EQ(pattern->size(), 21u);
+
+    // Differing byte wildcarded
+    mask[20] = 0;
+    EXPECT_FALSE(generator.shortestUnique(0x2000, second, mask));
+
+    // Outside of the regions or not matching at address
+    EXPECT_FALSE(generator.shortestUnique(0x3000, second, mask));
+    EXPECT_FALSE(generator.shortestUnique(0x1001, second, mask));
+}
+
+#ifdef B3L_HAVE_ASSEMBLERS
+TEST(SignatureGeneratorTests, GenerateWildcardsVolatileFields) {
+    // mov rax, [rip+disp32]; call rel32; mov rcx, imm64; ret/int3. The copies differ in every volatile field and only
+    // in their last byte otherwise.
+    const std::vector<uint8_t> first = { 0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44, 0xE8, 0x55, 0x66, 0x77, 0x88,
+                                         0x48, 0xB9, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xC3 };
+    const std::vector<uint8_t> second = { 0x48, 0x8B, 0x05, 0x99, 0xAA, 0xBB, 0xCC, 0xE8, 0xDD, 0xEE, 0xFF, 0x00,
+                                          0x48, 0xB9, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0xCC };
+
+    std::vector<uint8_t> code(first);
+    code.insert(code.end(), second.begin(), second.end());
+    code.resize(code.size() + 16, 0xCC);
+
+    constexpr uint64_t base = 0x140001000;
+    const auto target       = base + first.size();
+
+    // The imm64 of the second copy is a relocated field
+    SignatureGenerator generator({ { base, code } }, { { target + 14, 8 } }, true);
+
+    const auto pattern = generator.generate(target);
+    ASSERT_TRUE(pattern);
+
+    // Only the last byte tells the copies apart
+    ASSERT_EQ(pattern->size(), second.size());
+    std::vector<uint8_t> expectedMask(second.size(), 0xFF);
+    std::fill_n(expectedMask.begin() + 3, 4, 0);  // disp32
+    std::fill_n(expectedMask.begin() + 8, 4, 0);  // rel32
+    std::fill_n(expectedMask.begin() + 14, 8, 0); // Relocated imm64
+    EXPECT_EQ(std::vector<uint8_t>(pattern->mask().begin(), pattern->mask().end()), expectedMask);
+
+    // Unique and minimal
+    EXPECT_EQ(countMatches(code, *pattern), 1u);
+    EXPECT_TRUE(pattern->matchesAt(code.data() + first.size()));
+    const auto shorter = AOBPattern::fromBytes(pattern->value().first(pattern->size() - 1),
+                                               pattern->mask().first(pattern->size() - 1));
+    EXPECT_EQ(countMatches(code, *shorter), 2u);
+
+    // Without the relocation the imm64 stays exact and its first byte already tells the copies apart
+    SignatureGenerator unrelocated({ { base, code } }, {}, true);
+    const auto exactImmediate = unrelocated.generate(target);
+    ASSERT_TRUE(exactImmediate);
+    EXPECT_EQ(exactImmediate->size(), 15u);
+}
+#endif
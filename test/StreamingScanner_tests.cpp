@@ -0,0 +1,49 @@
+#include "B3L/StreamingScanner.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace B3L;
+
+TEST(StreamingScannerTests, MatchAcrossChunks) {
+    const std::vector<uint8_t> first{ 0x00, 0x48, 0x8B };
+    const std::vector<uint8_t> second{ 0x05 };
+    const std::vector<uint8_t> third{ 0x11, 0x48, 0x8B, 0x05, 0x22 };
+
+    StreamingScanner scanner(AOBPattern::fromString("48 8B 05 ??").value());
+
+    EXPECT_TRUE(scanner.feed(first).empty());
+    EXPECT_TRUE(scanner.feed(second).empty());
+    EXPECT_EQ(scanner.feed(third), (std::vector<uint64_t>{ 1, 5 }));
+    EXPECT_EQ(scanner.position(), 9);
+}
+
+// Streaming results have to agree with a scan of the whole input regardless of how it is split up.
+TEST(StreamingScannerTests, MatchesContiguousScan) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> byteDist(0, 3);
+    std::uniform_int_distribution<size_t> chunkDist(0, 9);
+
+    std::vector<uint8_t> input(4096);
+    for(auto& b : input)
+        b = static_cast<uint8_t>(byteDist(rng));
+
+    for(const auto& str : { "01 02 03", "?? 03 ?? 01 02", "00", "03 03 03 03 03 03 03 03 03" }) {
+        auto needle = AOBPattern::fromString(str).value();
+
+        std::vector<uint64_t> expected;
+        for(auto it : AOBScanner::matches(input.begin(), input.end(), needle))
+            expected.push_back(std::distance(input.begin(), it));
+
+        StreamingScanner scanner(needle);
+        std::vector<uint64_t> actual;
+
+        size_t pos = 0;
+        while(pos < input.size()) {
+            const auto size = (std::min)(chunkDist(rng), input.size() - pos);
+            scanner.feed({ input.data() + pos, size }, [&](uint64_t offset) { actual.push_back(offset); });
+            pos += size;
+        }
+
+        EXPECT_EQ(actual, expected) << str;
+    }
+}
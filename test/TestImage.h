@@ -0,0 +1,236 @@
+#pragma once
+#include "B3L/PE.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Builds minimal PE32+ or PE32 files in their on-disk layout for tests that can't rely on a loaded module.
+struct TestImage {
+    struct Section {
+        std::string name;
+        uint32_t characteristics = 0;
+        std::vector<uint8_t> data;
+        uint32_t virtualSize = 0; // data.size() if 0
+    };
+
+    static constexpr uint32_t fileAlignment    = 0x200;
+    static constexpr uint32_t sectionAlignment = 0x1000;
+    static constexpr uint32_t sizeOfHeaders    = 0x400;
+    static constexpr uint64_t imageBase        = 0x140000000;
+    static constexpr uint32_t imageBase32      = 0x400000; // ImageBase of PE32 images
+
+    struct Import {
+        std::string module;
+        std::vector<std::string> names;
+        std::vector<uint16_t> ordinals;
+    };
+
+    struct Export {
+        std::string name; // Exported by ordinal only if empty
+        uint32_t rva = 0;
+        std::string forwarder; // Replaces rva if not empty
+    };
+
+    struct Relocation {
+        uint32_t rva = 0;
+        int type     = B3L::PE::RelocationType::Dir64;
+    };
+
+    std::vector<Section> sections;
+    B3L::PE::DataDirectory directories[B3L::PE::numberOfDirectoryEntries]{};
+    uint32_t timeDateStamp = 0x5F000000;
+    bool pe32              = false; // Builds a PE32 image instead of PE32+, addImportSection still writes 64 bit thunks
+
+    // RVA of section index in the built image.
+    [[nodiscard]] static uint32_t sectionRVA(size_t index) {
+        return static_cast<uint32_t>((index + 1) * sectionAlignment);
+    }
+
+    // Raw data is aligned to alignment, which includes the end of the headers.
+    [[nodiscard]] std::vector<uint8_t> build(uint32_t alignment = fileAlignment) const {
+        std::vector<uint8_t> file((sizeOfHeaders + alignment - 1) / alignment * alignment);
+
+        B3L::PE::DosHeader dos{};
+        dos.e_magic  = B3L::PE::dosSignature;
+        dos.e_lfanew = sizeof(dos);
+
+        B3L::PE::FileHeader fileHeader{};
+        fileHeader.Machine              = pe32 ? 0x14C : 0x8664;
+        fileHeader.NumberOfSections     = static_cast<uint16_t>(sections.size());
+        fileHeader.TimeDateStamp        = timeDateStamp;
+        fileHeader.SizeOfOptionalHeader = pe32 ? sizeof(B3L::PE::OptionalHeader32) : sizeof(B3L::PE::OptionalHeader64);
+
+        auto fillOptional = [&](auto& optional) {
+            optional.SectionAlignment    = sectionAlignment;
+            optional.FileAlignment       = alignment;
+            optional.SizeOfImage         = sectionRVA(sections.size());
+            optional.SizeOfHeaders       = sizeOfHeaders;
+            optional.NumberOfRvaAndSizes = B3L::PE::numberOfDirectoryEntries;
+            std::copy(std::begin(directories), std::end(directories), optional.DataDirectory);
+        };
+
+        size_t offset = 0;
+        auto append   = [&](const auto& value) {
+            std::memcpy(file.data() + offset, &value, sizeof(value));
+            offset += sizeof(value);
+        };
+
+        append(dos);
+        append(B3L::PE::ntSignature);
+        append(fileHeader);
+        if(pe32) {
+            B3L::PE::OptionalHeader32 optional{};
+            optional.Magic     = B3L::PE::optionalHeader32Magic;
+            optional.ImageBase = imageBase32;
+            fillOptional(optional);
+            append(optional);
+        } else {
+            B3L::PE::OptionalHeader64 optional{};
+            optional.Magic     = B3L::PE::optionalHeader64Magic;
+            optional.ImageBase = imageBase;
+            fillOptional(optional);
+            append(optional);
+        }
+
+        for(size_t i = 0; i < sections.size(); ++i) {
+            const auto& section = sections[i];
+            if(section.data.size() > sectionAlignment || section.virtualSize > sectionAlignment)
+                throw std::length_error("Test image sections are limited to one page");
+
+            const auto rawSize = (section.data.size() + alignment - 1) / alignment * alignment;
+
+            B3L::PE::SectionHeader header{};
+            std::memcpy(header.Name, section.name.data(), (std::min)(section.name.size(), sizeof(header.Name)));
+            header.Misc.VirtualSize = section.virtualSize ? section.virtualSize : static_cast<uint32_t>(section.data.size());
+            header.VirtualAddress   = sectionRVA(i);
+            header.SizeOfRawData    = static_cast<uint32_t>(rawSize);
+            header.PointerToRawData = static_cast<uint32_t>(file.size());
+            header.Characteristics  = section.characteristics;
+            append(header);
+
+            file.insert(file.end(), section.data.begin(), section.data.end());
+            file.resize(header.PointerToRawData + rawSize);
+        }
+
+        return file;
+    }
+
+    // Image as the loader lays it out by virtual address, without relocating it or resolving imports.
+    [[nodiscard]] std::vector<uint8_t> buildMapped() const {
+        const auto file = build();
+
+        std::vector<uint8_t> image(sectionRVA(sections.size()));
+        std::copy_n(file.begin(), sizeOfHeaders, image.begin());
+        for(size_t i = 0; i < sections.size(); ++i)
+            std::copy(sections[i].data.begin(), sections[i].data.end(), image.begin() + sectionRVA(i));
+
+        return image;
+    }
+
+    // Appends an .idata section holding an import directory for imports and points the import directory entry to
+    // it. Imports are listed by name first, then by ordinal. IAT entries hold the same values as the lookup table,
+    // like in an image on disk.
+    void addImportSection(const std::vector<Import>& imports) {
+        const auto rva = sectionRVA(sections.size());
+
+        std::vector<uint8_t> data((imports.size() + 1) * sizeof(B3L::PE::ImportDescriptor));
+        auto append = [&](const void* bytes, size_t size) {
+            const auto offset = static_cast<uint32_t>(data.size());
+            data.insert(data.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+            data.resize((data.size() + 7) / 8 * 8);
+            return rva + offset;
+        };
+
+        for(size_t i = 0; i < imports.size(); ++i) {
+            const auto& import = imports[i];
+
+            std::vector<B3L::PE::ThunkData64> thunks;
+            for(const auto& name : import.names) {
+                std::vector<uint8_t> hintName(sizeof(uint16_t) + name.size() + 1);
+                std::memcpy(hintName.data() + sizeof(uint16_t), name.data(), name.size());
+                thunks.push_back({ { append(hintName.data(), hintName.size()) } });
+            }
+            for(auto ordinal : import.ordinals)
+                thunks.push_back({ { B3L::PE::ordinalFlag64 | ordinal } });
+            thunks.push_back({});
+
+            B3L::PE::ImportDescriptor descriptor{};
+            descriptor.Name               = append(import.module.c_str(), import.module.size() + 1);
+            descriptor.OriginalFirstThunk = append(thunks.data(), thunks.size() * sizeof(thunks[0]));
+            descriptor.FirstThunk         = append(thunks.data(), thunks.size() * sizeof(thunks[0]));
+            std::memcpy(data.data() + i * sizeof(descriptor), &descriptor, sizeof(descriptor));
+        }
+
+        directories[B3L::PE::DirectoryEntry::Import] = { rva, static_cast<uint32_t>((imports.size() + 1) * sizeof(B3L::PE::ImportDescriptor)) };
+        sections.push_back({ ".idata", B3L::PE::SectionCharacteristics::MemRead | B3L::PE::SectionCharacteristics::MemWrite, data });
+    }
+
+    // Appends an .edata section holding an export directory for exports and points the export directory entry to it.
+    // Ordinals are assigned in order starting at ordinalBase, names are sorted like the loader expects them.
+    void addExportSection(const std::string& module, uint32_t ordinalBase, const std::vector<Export>& exports) {
+        const auto rva = sectionRVA(sections.size());
+
+        std::vector<uint8_t> data(sizeof(B3L::PE::ExportDirectory));
+        auto append = [&](const void* bytes, size_t size) {
+            const auto offset = static_cast<uint32_t>(data.size());
+            data.insert(data.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+            data.resize((data.size() + 3) / 4 * 4);
+            return rva + offset;
+        };
+
+        std::vector<uint16_t> named;
+        for(size_t i = 0; i < exports.size(); ++i) {
+            if(!exports[i].name.empty())
+                named.push_back(static_cast<uint16_t>(i));
+        }
+        std::sort(named.begin(), named.end(), [&](uint16_t a, uint16_t b) { return exports[a].name < exports[b].name; });
+
+        std::vector<uint32_t> functions, names;
+        for(const auto& entry : exports)
+            functions.push_back(entry.forwarder.empty() ? entry.rva : append(entry.forwarder.c_str(), entry.forwarder.size() + 1));
+        for(auto index : named)
+            names.push_back(append(exports[index].name.c_str(), exports[index].name.size() + 1));
+
+        B3L::PE::ExportDirectory directory{};
+        directory.Name                  = append(module.c_str(), module.size() + 1);
+        directory.Base                  = ordinalBase;
+        directory.NumberOfFunctions     = static_cast<uint32_t>(functions.size());
+        directory.NumberOfNames         = static_cast<uint32_t>(names.size());
+        directory.AddressOfFunctions    = append(functions.data(), functions.size() * sizeof(functions[0]));
+        directory.AddressOfNames        = append(names.data(), names.size() * sizeof(names[0]));
+        directory.AddressOfNameOrdinals = append(named.data(), named.size() * sizeof(named[0]));
+        std::memcpy(data.data(), &directory, sizeof(directory));
+
+        directories[B3L::PE::DirectoryEntry::Export] = { rva, static_cast<uint32_t>(data.size()) };
+        sections.push_back({ ".edata", B3L::PE::SectionCharacteristics::MemRead, data });
+    }
+
+    // Appends a .reloc section holding a base relocation block for every page referenced by relocations and points
+    // the base relocation directory entry to it. Relocations of a page keep their order.
+    void addRelocationSection(const std::vector<Relocation>& relocations) {
+        std::vector<Relocation> sorted = relocations;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Relocation& a, const Relocation& b) { return a.rva / 0x1000 < b.rva / 0x1000; });
+
+        std::vector<uint8_t> data;
+        for(size_t begin = 0; begin < sorted.size();) {
+            const auto page = sorted[begin].rva & ~0xFFFu;
+
+            std::vector<uint16_t> entries;
+            for(; begin < sorted.size() && (sorted[begin].rva & ~0xFFFu) == page; ++begin)
+                entries.push_back(static_cast<uint16_t>(sorted[begin].type << 12 | (sorted[begin].rva & 0xFFF)));
+            if(entries.size() % 2)
+                entries.push_back(B3L::PE::RelocationType::Absolute); // Blocks are 4 byte aligned
+
+            const B3L::PE::BaseRelocation header{ page, static_cast<uint32_t>(sizeof(header) + entries.size() * sizeof(uint16_t)) };
+            data.insert(data.end(), reinterpret_cast<const uint8_t*>(&header), reinterpret_cast<const uint8_t*>(&header + 1));
+            data.insert(data.end(), reinterpret_cast<const uint8_t*>(entries.data()), reinterpret_cast<const uint8_t*>(entries.data() + entries.size()));
+        }
+
+        directories[B3L::PE::DirectoryEntry::BaseReloc] = { sectionRVA(sections.size()), static_cast<uint32_t>(data.size()) };
+        sections.push_back({ ".reloc", B3L::PE::SectionCharacteristics::MemRead, data });
+    }
+};